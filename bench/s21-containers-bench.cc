@@ -0,0 +1,305 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "s21_containers.h"
+
+namespace {
+
+template <typename Func>
+double Measure(Func&& func, int repeats = 3) {
+  double best = 0;
+  for (int i = 0; i < repeats; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (i == 0 || elapsed.count() < best) {
+      best = elapsed.count();
+    }
+  }
+  return best;
+}
+
+void Report(const char* name, double ms) {
+  std::printf("%-48s %10.2f ms\n", name, ms);
+}
+
+volatile long long sink;
+
+template <typename List>
+void BenchTraversal(const char* name, size_t n) {
+  List lst;
+  for (size_t i = 0; i != n; ++i) {
+    lst.push_back(static_cast<int>(i));
+  }
+  Report(name, Measure([&] {
+           long long sum = 0;
+           for (auto val : lst) {
+             sum += val;
+           }
+           sink = sum;
+         }));
+}
+
+template <typename List>
+void BenchInsertMiddle(const char* name, size_t n, size_t inserts) {
+  Report(name, Measure([&] {
+           List lst;
+           for (size_t i = 0; i != n; ++i) {
+             lst.push_back(static_cast<int>(i));
+           }
+           auto it = lst.begin();
+           for (size_t i = 0; i != n / 2; ++i) {
+             ++it;
+           }
+           for (size_t i = 0; i != inserts; ++i) {
+             it = lst.insert(it, static_cast<int>(i));
+           }
+           sink = static_cast<long long>(lst.size());
+         }));
+}
+
+template <typename Map>
+void BenchMap(const char* name, size_t n) {
+  std::string label(name);
+  Map* map = nullptr;
+  Report((label + " build").c_str(), Measure(
+                                         [&] {
+                                           delete map;
+                                           map = new Map();
+                                           for (size_t i = 0; i != n; ++i) {
+                                             map->insert(
+                                                 static_cast<int>(i * 7919 % n),
+                                                 static_cast<int>(i));
+                                           }
+                                         },
+                                         1));
+  Report((label + " lookup").c_str(), Measure([&] {
+           long long sum = 0;
+           for (size_t i = 0; i != n; ++i) {
+             sum += map->contains(static_cast<int>(i * 104729 % n));
+           }
+           sink = sum;
+         }));
+  Report((label + " teardown").c_str(), Measure([&] { delete map; }, 1));
+}
+
+template <typename Map>
+void BenchSortedLoad(const char* name, size_t n, bool hinted) {
+  Report(name, Measure([&] {
+           Map map;
+           for (size_t i = 0; i != n; ++i) {
+             typename Map::value_type item(static_cast<int>(i),
+                                           static_cast<int>(i));
+             if (hinted) {
+               map.insert(map.end(), item);
+             } else {
+               map.insert(item);
+             }
+           }
+           sink = static_cast<long long>(map.size());
+         }));
+}
+
+template <typename Map>
+void BenchSortedBuild(const char* name, size_t n) {
+  s21::vector<typename Map::value_type> items;
+  items.reserve(n);
+  for (size_t i = 0; i != n; ++i) {
+    items.push_back({static_cast<int>(i), static_cast<int>(i)});
+  }
+  Report(name, Measure([&] {
+           Map map(s21::sorted_unique, items.begin(), items.end());
+           sink = static_cast<long long>(map.size());
+         }));
+}
+
+template <typename Map>
+void BenchMerge(const char* name, size_t n) {
+  Map lhs, rhs;
+  for (size_t i = 0; i != n; ++i) {
+    lhs.insert(lhs.end(), {static_cast<int>(2 * i), 0});
+    rhs.insert(rhs.end(), {static_cast<int>(2 * i + 1), 0});
+  }
+  Report(name, Measure([&] { lhs.merge(rhs); }, 1));
+  sink = static_cast<long long>(lhs.size());
+}
+
+template <typename Map>
+void BenchCopy(const char* name, size_t n) {
+  Map map;
+  for (size_t i = 0; i != n; ++i) {
+    map.insert({static_cast<int>((i * 2654435761u) % n), 0});
+  }
+  Report(name, Measure([&] {
+           Map copy(map);
+           sink = static_cast<long long>(copy.size());
+         }));
+}
+
+// Publishes a snapshot for readers after every batch of 100 updates.
+template <typename Map>
+void BenchSnapshots(const char* name, size_t n, size_t batches) {
+  Map map;
+  for (size_t i = 0; i != n; ++i) {
+    map.insert({static_cast<int>((i * 2654435761u) % n), 0});
+  }
+  Report(name, Measure([&] {
+           for (size_t batch = 0; batch != batches; ++batch) {
+             Map snapshot(map);
+             for (size_t i = 0; i != 100; ++i) {
+               size_t key = (batch * 100 + i) * 2654435761u % n;
+               map.insert_or_assign(static_cast<int>(key),
+                                    static_cast<int>(i));
+             }
+             sink = static_cast<long long>(snapshot.size());
+           }
+         }));
+}
+
+// Drops every entry whose value is below a cutoff, as a TTL sweep would.
+template <typename Map>
+void BenchSweep(const char* name, size_t n, bool bulk) {
+  Map map;
+  for (size_t i = 0; i != n; ++i) {
+    map.insert(map.end(), {static_cast<int>(i), static_cast<int>(i % 10)});
+  }
+  Report(name, Measure(
+                   [&] {
+                     if (bulk) {
+                       map.erase_if([](const typename Map::value_type& item) {
+                         return item.second < 3;
+                       });
+                       return;
+                     }
+                     for (auto it = map.begin(); it != map.end();) {
+                       auto next = std::next(it);
+                       if ((*it).second < 3) {
+                         map.erase(it);
+                       }
+                       it = next;
+                     }
+                   },
+                   1));
+  sink = static_cast<long long>(map.size());
+}
+
+// Runs read_all on every thread while one writer changes an entry each
+// millisecond, and returns how long the readers took.
+template <typename ReadAll, typename WriteOne>
+double MeasureReaders(size_t threads, ReadAll read_all, WriteOne write_one) {
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    for (size_t i = 0; !done.load(); ++i) {
+      write_one(i);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> readers;
+  for (size_t t = 0; t != threads; ++t) {
+    readers.emplace_back(read_all, t);
+  }
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  done = true;
+  writer.join();
+  return elapsed.count();
+}
+
+// Every reader does the same number of lookups, so times that stay flat
+// as threads are added mean reads scale.
+void BenchReadScaling(size_t n, size_t lookups) {
+  s21::map<int, int> locked;
+  std::shared_mutex mutex;
+  s21::concurrent_map<int, int> shared;
+  shared.update([&](auto& map) {
+    for (size_t i = 0; i != n; ++i) {
+      locked.insert(static_cast<int>(i), 0);
+      map.insert(static_cast<int>(i), 0);
+    }
+  });
+  std::atomic<long long> found{0};
+  auto key = [n](size_t t, size_t i) {
+    return static_cast<int>((t * 7919 + i * 104729) % n);
+  };
+  for (size_t threads = 1; threads <= 32; threads *= 2) {
+    std::string label =
+        std::to_string(threads) + (threads == 1 ? " reader" : " readers");
+    Report(("map + shared_mutex, " + label).c_str(),
+           MeasureReaders(
+               threads,
+               [&](size_t t) {
+                 long long sum = 0;
+                 for (size_t i = 0; i != lookups; ++i) {
+                   std::shared_lock<std::shared_mutex> lock(mutex);
+                   sum += locked.contains(key(t, i));
+                 }
+                 found += sum;
+               },
+               [&](size_t i) {
+                 std::unique_lock<std::shared_mutex> lock(mutex);
+                 locked.insert_or_assign(key(0, i), static_cast<int>(i));
+               }));
+    Report(("concurrent_map, " + label).c_str(),
+           MeasureReaders(
+               threads,
+               [&](size_t t) {
+                 s21::concurrent_map<int, int>::reader reader(shared);
+                 long long sum = 0;
+                 for (size_t i = 0; i != lookups; ++i) {
+                   sum += reader.contains(key(t, i));
+                 }
+                 found += sum;
+               },
+               [&](size_t i) {
+                 shared.insert_or_assign(key(0, i), static_cast<int>(i));
+               }));
+  }
+  sink = found.load();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+
+  std::printf("n = %zu\n", n);
+  BenchTraversal<s21::list<int>>("list traversal", n);
+  BenchTraversal<s21::unrolled_list<int>>("unrolled_list traversal", n);
+  BenchInsertMiddle<s21::list<int>>("list build + insert in middle", n, n / 10);
+  BenchInsertMiddle<s21::unrolled_list<int>>(
+      "unrolled_list build + insert in middle", n, n / 10);
+  BenchMap<s21::map<int, int>>("map", n);
+  BenchMap<s21::map<int, int, std::less<int>,
+                    s21::pool_allocator<std::pair<int, int>>>>("pooled map", n);
+  BenchMap<s21::persistent_map<int, int>>("persistent_map", n);
+  BenchSortedLoad<s21::map<int, int>>("map sorted load", n, false);
+  BenchSortedLoad<s21::map<int, int>>("map sorted load, end() hint", n, true);
+  BenchSortedBuild<s21::map<int, int>>("map sorted_unique build", n);
+  BenchSortedBuild<s21::map<int, int, std::less<int>,
+                            s21::pool_allocator<std::pair<int, int>>>>(
+      "pooled map sorted_unique build", n);
+  BenchMerge<s21::map<int, int>>("map merge of two interleaved halves", n / 2);
+  BenchCopy<s21::map<int, int>>("map copy", n);
+  BenchCopy<s21::map<int, int, std::less<int>,
+                     s21::pool_allocator<std::pair<int, int>>>>(
+      "pooled map copy", n);
+  BenchSnapshots<s21::map<int, int>>("map 10 snapshots, copying", n, 10);
+  BenchSnapshots<s21::persistent_map<int, int>>(
+      "persistent_map 10 snapshots, path copying", n, 10);
+  BenchSweep<s21::map<int, int>>("map sweep, erase per entry", n, false);
+  BenchSweep<s21::map<int, int>>("map sweep, erase_if", n, true);
+  BenchReadScaling(n / 10, n / 10);
+  return 0;
+}
@@ -0,0 +1,224 @@
+#ifndef S21_CONTAINER_SRC_S21_CONCURRENT_MAP_H_
+#define S21_CONTAINER_SRC_S21_CONCURRENT_MAP_H_
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_persistent_map.h"
+
+namespace s21 {
+
+// Ordered map for many readers and rare writers. Every update builds the
+// next version of a persistent_map from the current one (copying O(log n)
+// nodes) and publishes it with one atomic store, so readers never lock and
+// never write to memory another thread touches. Writers are serialized by a
+// mutex.
+//
+// A version a reader may still be walking is freed by epoch-based
+// reclamation: each reader claims a slot on a cache line of its own and
+// stores the epoch it entered in; a retired version is freed once no
+// reader is in an epoch from before it was replaced. Writers never wait
+// for readers, they only free what has become unreachable; that happens on
+// every update and on reclaim(), so a version retired while a reader held
+// it stays allocated until one of them runs after the reader is done.
+template <typename Key, typename Tp, typename Compare = std::less<Key>,
+          typename Alloc = std::allocator<std::pair<Key, Tp>>,
+          size_t MaxReaders = 64>
+class concurrent_map {
+  static constexpr size_t kCacheLine = 64;
+  static constexpr uint64_t kIdle = std::numeric_limits<uint64_t>::max();
+
+ public:
+  using key_type = Key;
+  using mapped_type = Tp;
+  using map_type = persistent_map<Key, Tp, Compare, Alloc>;
+  using value_type = typename map_type::value_type;
+  using size_type = typename map_type::size_type;
+
+ private:
+  struct Version {
+    map_type map;
+    uint64_t retired_at{};
+    Version* next{};
+  };
+
+  struct alignas(kCacheLine) ReaderSlot {
+    std::atomic<uint64_t> epoch{kIdle};
+    std::atomic<bool> taken{};
+  };
+
+ public:
+  // A reading thread's handle. It claims one of the MaxReaders slots for
+  // its lifetime and must be used by one thread at a time.
+  class reader {
+   public:
+    explicit reader(const concurrent_map& map) : map_(map) {
+      for (auto& slot : map.slots_) {
+        if (!slot.taken.exchange(true, std::memory_order_acquire)) {
+          slot_ = &slot;
+          return;
+        }
+      }
+      throw std::length_error("Too many concurrent_map readers");
+    }
+
+    reader(const reader&) = delete;
+    reader& operator=(const reader&) = delete;
+
+    ~reader() { slot_->taken.store(false, std::memory_order_release); }
+
+    // Calls func with the latest version and returns what it returns. The
+    // version stays alive until func is done; keep no references into it.
+    // func may call read() again: a nested read keeps the outer epoch, which
+    // is no later than its own and so protects both versions.
+    template <typename Func>
+    decltype(auto) read(Func&& func) const {
+      struct Section {
+        ~Section() { slot->epoch.store(outer, std::memory_order_release); }
+        ReaderSlot* slot;
+        uint64_t outer;
+      } section{slot_, slot_->epoch.load(std::memory_order_relaxed)};
+      if (section.outer == kIdle) {
+        slot_->epoch.store(map_.epoch_.load(std::memory_order_acquire));
+      }
+      return func(map_.current_.load()->map);
+    }
+
+    bool contains(const Key& key) const {
+      return read([&key](const map_type& map) { return map.contains(key); });
+    }
+
+    std::optional<mapped_type> get(const Key& key) const {
+      return read([&key](const map_type& map) {
+        auto it = map.find(key);
+        return it == map.end() ? std::nullopt
+                               : std::optional<mapped_type>(it->second);
+      });
+    }
+
+    size_type size() const {
+      return read([](const map_type& map) { return map.size(); });
+    }
+
+    // A version of its own that outlives the read; copying it is O(1).
+    map_type snapshot() const {
+      return read([](const map_type& map) { return map; });
+    }
+
+   private:
+    const concurrent_map& map_;
+    ReaderSlot* slot_;
+  };
+
+  concurrent_map() : current_(new Version{}) {}
+
+  explicit concurrent_map(map_type map)
+      : current_(new Version{std::move(map)}) {}
+
+  concurrent_map(const concurrent_map&) = delete;
+  concurrent_map& operator=(const concurrent_map&) = delete;
+
+  // No reader may be inside read() anymore.
+  ~concurrent_map() {
+    delete current_.load(std::memory_order_relaxed);
+    while (retired_) {
+      Version* next = retired_->next;
+      delete retired_;
+      retired_ = next;
+    }
+  }
+
+  map_type snapshot() const {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    return current_.load(std::memory_order_relaxed)->map;
+  }
+
+  bool insert(const Key& key, const Tp& obj) {
+    return Update([&](map_type& map) { return map.insert(key, obj); });
+  }
+
+  template <typename M>
+  bool insert_or_assign(const Key& key, M&& obj) {
+    return Update([&](map_type& map) {
+      map.insert_or_assign(key, std::forward<M>(obj));
+      return true;
+    });
+  }
+
+  size_type erase(const Key& key) {
+    return Update([&](map_type& map) { return map.erase(key) != 0; });
+  }
+
+  // Applies func to a copy of the latest version and publishes the result
+  // as one version, so readers see all of func's changes or none of them.
+  template <typename Func>
+  void update(Func&& func) {
+    Update([&func](map_type& map) {
+      func(map);
+      return true;
+    });
+  }
+
+  // Frees the retired versions no reader can still be in, for when no
+  // update is coming to do it.
+  void reclaim() {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    Reclaim();
+  }
+
+ private:
+  // Publishes the next version when func reports a change. A reader that
+  // saw the old version entered in an epoch no later than the one the
+  // swap retires it in, and its slot store is ordered before the swap, so
+  // the scan below cannot miss it.
+  template <typename Func>
+  bool Update(Func func) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    Version* old = current_.load(std::memory_order_relaxed);
+    map_type next(old->map);
+    if (!func(next)) {
+      return false;
+    }
+    current_.store(new Version{std::move(next)});
+    old->retired_at = epoch_.fetch_add(1);
+    old->next = retired_;
+    retired_ = old;
+    Reclaim();
+    return true;
+  }
+
+  void Reclaim() noexcept {
+    uint64_t oldest = kIdle;
+    for (auto& slot : slots_) {
+      uint64_t epoch = slot.epoch.load();
+      oldest = epoch < oldest ? epoch : oldest;
+    }
+    for (Version** link = &retired_; *link;) {
+      if ((*link)->retired_at < oldest) {
+        Version* dead = *link;
+        *link = dead->next;
+        delete dead;
+      } else {
+        link = &(*link)->next;
+      }
+    }
+  }
+
+  // Read by every reader, written once per update.
+  alignas(kCacheLine) std::atomic<Version*> current_;
+  std::atomic<uint64_t> epoch_{};
+
+  alignas(kCacheLine) mutable ReaderSlot slots_[MaxReaders];
+
+  alignas(kCacheLine) mutable std::mutex writer_mutex_;
+  Version* retired_{};
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINER_SRC_S21_CONCURRENT_MAP_H_
@@ -1,10 +1,16 @@
-#ifndef S21_CONTAINER_SRC_S21_CONTAINERS_H_
-#define S21_CONTAINER_SRC_S21_CONTAINERS_H_
-
-#include "s21_list.h"
-#include "s21_map.h"
-#include "s21_multiset.h"
-#include "s21_set.h"
-#include "s21_vector.h"
-
+#ifndef S21_CONTAINER_SRC_S21_CONTAINERS_H_
+#define S21_CONTAINER_SRC_S21_CONTAINERS_H_
+
+#include "s21_concurrent_map.h"
+#include "s21_forward_list.h"
+#include "s21_interval_map.h"
+#include "s21_list.h"
+#include "s21_map.h"
+#include "s21_multiset.h"
+#include "s21_node_pool.h"
+#include "s21_persistent_map.h"
+#include "s21_set.h"
+#include "s21_unrolled_list.h"
+#include "s21_vector.h"
+
 #endif  // S21_CONTAINER_SRC_S21_CONTAINERS_H_
\ No newline at end of file
@@ -0,0 +1,503 @@
+#ifndef S21_CONTAINER_SRC_S21_FORWARD_LIST_H_
+#define S21_CONTAINER_SRC_S21_FORWARD_LIST_H_
+
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <utility>
+
+namespace s21 {
+
+struct ForwardListNodeBase {
+  ForwardListNodeBase* next{};
+};
+
+template <typename Tp>
+struct ForwardListNode : public ForwardListNodeBase {
+  template <typename... Args>
+  explicit ForwardListNode(std::in_place_t, Args&&... args)
+      : data(std::forward<Args>(args)...) {}
+
+  Tp data;
+};
+
+template <typename Tp>
+struct ForwardListIterator {
+  using Node = ForwardListNode<Tp>;
+  using difference_type = ptrdiff_t;
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = Tp;
+  using pointer = Tp*;
+  using reference = Tp&;
+
+  ForwardListIterator() noexcept : node() {}
+
+  explicit ForwardListIterator(ForwardListNodeBase* node) noexcept
+      : node(node) {}
+
+  reference operator*() const noexcept {
+    return static_cast<Node*>(node)->data;
+  }
+
+  pointer operator->() const noexcept {
+    return &static_cast<Node*>(node)->data;
+  }
+
+  ForwardListIterator& operator++() noexcept {
+    node = node->next;
+    return *this;
+  }
+
+  ForwardListIterator operator++(int) noexcept {
+    ForwardListIterator ret(*this);
+    node = node->next;
+    return ret;
+  }
+
+  friend bool operator==(const ForwardListIterator& lhs,
+                         const ForwardListIterator& rhs) noexcept {
+    return lhs.node == rhs.node;
+  }
+
+  friend bool operator!=(const ForwardListIterator& lhs,
+                         const ForwardListIterator& rhs) noexcept {
+    return lhs.node != rhs.node;
+  }
+
+  ForwardListNodeBase* node;
+};
+
+template <typename Tp>
+struct ForwardListConstIterator {
+  using iterator = ForwardListIterator<Tp>;
+  using Node = const ForwardListNode<Tp>;
+  using difference_type = ptrdiff_t;
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = Tp;
+  using pointer = const Tp*;
+  using reference = const Tp&;
+
+  ForwardListConstIterator() noexcept : node() {}
+
+  explicit ForwardListConstIterator(const ForwardListNodeBase* node) noexcept
+      : node(node) {}
+
+  ForwardListConstIterator(const iterator& it) noexcept : node(it.node) {}
+
+  iterator const_cast_() const noexcept {
+    return iterator(const_cast<ForwardListNodeBase*>(node));
+  }
+
+  reference operator*() const noexcept {
+    return static_cast<Node*>(node)->data;
+  }
+
+  pointer operator->() const noexcept {
+    return &static_cast<Node*>(node)->data;
+  }
+
+  ForwardListConstIterator& operator++() noexcept {
+    node = node->next;
+    return *this;
+  }
+
+  ForwardListConstIterator operator++(int) noexcept {
+    ForwardListConstIterator ret(*this);
+    node = node->next;
+    return ret;
+  }
+
+  friend bool operator==(const ForwardListConstIterator& lhs,
+                         const ForwardListConstIterator& rhs) noexcept {
+    return lhs.node == rhs.node;
+  }
+
+  friend bool operator!=(const ForwardListConstIterator& lhs,
+                         const ForwardListConstIterator& rhs) noexcept {
+    return lhs.node != rhs.node;
+  }
+
+  const ForwardListNodeBase* node;
+};
+
+template <typename Tp, typename Alloc = std::allocator<Tp>>
+class forward_list {
+ public:
+  using value_type = Tp;
+  using reference = Tp&;
+  using const_reference = const Tp&;
+  using pointer = Tp*;
+  using const_pointer = const Tp*;
+  using Node = ForwardListNode<value_type>;
+  using iterator = ForwardListIterator<value_type>;
+  using const_iterator = ForwardListConstIterator<value_type>;
+  using size_type = size_t;
+  using allocator_type = Alloc;
+
+  forward_list() = default;
+
+  explicit forward_list(size_type n) : forward_list() {
+    for (iterator pos = before_begin(); n != 0; --n) {
+      pos = emplace_after(pos);
+    }
+  }
+
+  forward_list(std::initializer_list<value_type> const& items)
+      : forward_list() {
+    insert_after(before_begin(), items.begin(), items.end());
+  }
+
+  forward_list(const forward_list& other)
+      : allocator_(NodeTraits::select_on_container_copy_construction(
+            other.allocator_)) {
+    insert_after(before_begin(), other.begin(), other.end());
+  }
+
+  forward_list(forward_list&& other) noexcept
+      : allocator_(std::move(other.allocator_)) {
+    head_.next = other.head_.next;
+    other.head_.next = nullptr;
+  }
+
+  ~forward_list() { clear(); }
+
+  forward_list& operator=(const forward_list& other) {
+    if (this != &other) {
+      forward_list tmp(other);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  forward_list& operator=(forward_list&& other) noexcept {
+    forward_list tmp(std::move(other));
+    if (this != &other) {
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  void clear() noexcept { erase_after(cbefore_begin(), cend()); }
+
+  bool empty() const noexcept { return head_.next == nullptr; }
+
+  size_type max_size() const noexcept {
+    return NodeTraits::max_size(allocator_);
+  }
+
+  reference front() noexcept { return *begin(); }
+
+  const_reference front() const noexcept { return *begin(); }
+
+  void push_front(const_reference value) {
+    emplace_after(cbefore_begin(), value);
+  }
+
+  void push_front(value_type&& value) {
+    emplace_after(cbefore_begin(), std::move(value));
+  }
+
+  template <typename... Args>
+  void emplace_front(Args&&... args) {
+    emplace_after(cbefore_begin(), std::forward<Args>(args)...);
+  }
+
+  void pop_front() noexcept { erase_after(cbefore_begin()); }
+
+  iterator insert_after(const_iterator pos, const_reference value) {
+    return emplace_after(pos, value);
+  }
+
+  iterator insert_after(const_iterator pos, value_type&& value) {
+    return emplace_after(pos, std::move(value));
+  }
+
+  // The new nodes are linked into a detached chain first and attached with
+  // a single relink, so a throwing constructor leaves the list untouched.
+  template <typename InputIt>
+  iterator insert_after(const_iterator pos, InputIt first, InputIt last) {
+    ForwardListNodeBase chain;
+    ForwardListNodeBase* tail = &chain;
+    try {
+      for (; first != last; ++first) {
+        tail = tail->next = CreateNode(*first);
+      }
+    } catch (...) {
+      DestroyChain(chain.next);
+      throw;
+    }
+    ForwardListNodeBase* prev = pos.const_cast_().node;
+    if (tail == &chain) {
+      return iterator(prev);
+    }
+    tail->next = prev->next;
+    prev->next = chain.next;
+    return iterator(tail);
+  }
+
+  template <typename... Args>
+  iterator insert_many_after(const_iterator pos, Args&&... args) {
+    iterator place = pos.const_cast_();
+    ((place = emplace_after(place, std::forward<Args>(args))), ...);
+    return place;
+  }
+
+  template <typename... Args>
+  iterator emplace_after(const_iterator pos, Args&&... args) {
+    ForwardListNodeBase* prev = pos.const_cast_().node;
+    Node* node = CreateNode(std::forward<Args>(args)...);
+    node->next = prev->next;
+    prev->next = node;
+    return iterator(node);
+  }
+
+  iterator erase_after(const_iterator pos) noexcept {
+    ForwardListNodeBase* prev = pos.const_cast_().node;
+    ForwardListNodeBase* node = prev->next;
+    prev->next = node->next;
+    DestroyNode(static_cast<Node*>(node));
+    return iterator(prev->next);
+  }
+
+  iterator erase_after(const_iterator first, const_iterator last) noexcept {
+    ForwardListNodeBase* prev = first.const_cast_().node;
+    ForwardListNodeBase* stop = last.const_cast_().node;
+    ForwardListNodeBase* node = prev->next;
+    while (node != stop) {
+      ForwardListNodeBase* next = node->next;
+      DestroyNode(static_cast<Node*>(node));
+      node = next;
+    }
+    prev->next = stop;
+    return iterator(stop);
+  }
+
+  // Nodes are relinked only between lists whose allocators can free each
+  // other's nodes; otherwise the values are moved over and other is
+  // cleared.
+  void splice_after(const_iterator pos, forward_list& other) {
+    if (other.empty()) {
+      return;
+    }
+    if (!SharesNodes(other)) {
+      insert_after(pos, std::make_move_iterator(other.begin()),
+                   std::make_move_iterator(other.end()));
+      other.clear();
+      return;
+    }
+    ForwardListNodeBase* prev = pos.const_cast_().node;
+    ForwardListNodeBase* last = &other.head_;
+    while (last->next) {
+      last = last->next;
+    }
+    last->next = prev->next;
+    prev->next = other.head_.next;
+    other.head_.next = nullptr;
+  }
+
+  void splice_after(const_iterator pos, forward_list& other,
+                    const_iterator it) {
+    ForwardListNodeBase* prev = pos.const_cast_().node;
+    ForwardListNodeBase* before = it.const_cast_().node;
+    ForwardListNodeBase* node = before->next;
+    if (prev == before || prev == node) {
+      return;
+    }
+    if (!SharesNodes(other)) {
+      emplace_after(pos, std::move(static_cast<Node*>(node)->data));
+      other.erase_after(it);
+      return;
+    }
+    before->next = node->next;
+    node->next = prev->next;
+    prev->next = node;
+  }
+
+  // Moves one element of other at a time, so a throwing comparison leaves
+  // every element in one of the two lists.
+  void merge(forward_list& other) {
+    if (this == &other) {
+      return;
+    }
+    if (SharesNodes(other)) {
+      MergeChains(head_, other.head_);
+      return;
+    }
+    ForwardListNodeBase* prev = &head_;
+    while (!other.empty()) {
+      while (prev->next && !(other.front() < Value(prev->next))) {
+        prev = prev->next;
+      }
+      prev = emplace_after(const_iterator(prev), std::move(other.front())).node;
+      other.pop_front();
+    }
+  }
+
+  // Bottom-up merge sort: bins[i] holds a sorted run of 2^i nodes. If a
+  // comparison throws, the runs are linked back in front of the unsorted
+  // rest, so no node is lost.
+  void sort() {
+    ForwardListNodeBase carry;
+    ForwardListNodeBase bins[64];
+    size_type filled = 0;
+    try {
+      while (head_.next) {
+        ForwardListNodeBase* node = head_.next;
+        head_.next = node->next;
+        node->next = nullptr;
+        carry.next = node;
+        size_type i = 0;
+        for (; i < filled && bins[i].next; ++i) {
+          MergeChains(bins[i], carry);
+          std::swap(carry.next, bins[i].next);
+        }
+        std::swap(carry.next, bins[i].next);
+        filled = i == filled ? filled + 1 : filled;
+      }
+      for (size_type i = 1; i < filled; ++i) {
+        MergeChains(bins[i], bins[i - 1]);
+      }
+    } catch (...) {
+      PrependChain(carry);
+      for (size_type i = 0; i < filled; ++i) {
+        PrependChain(bins[i]);
+      }
+      throw;
+    }
+    if (filled != 0) {
+      head_.next = bins[filled - 1].next;
+    }
+  }
+
+  void reverse() noexcept {
+    ForwardListNodeBase* reversed = nullptr;
+    ForwardListNodeBase* node = head_.next;
+    while (node) {
+      ForwardListNodeBase* next = node->next;
+      node->next = reversed;
+      reversed = node;
+      node = next;
+    }
+    head_.next = reversed;
+  }
+
+  void unique() {
+    if (empty()) {
+      return;
+    }
+    iterator curr = begin();
+    while (curr.node->next) {
+      if (*curr == *iterator(curr.node->next)) {
+        erase_after(curr);
+      } else {
+        ++curr;
+      }
+    }
+  }
+
+  void swap(forward_list& other) noexcept {
+    std::swap(head_.next, other.head_.next);
+    std::swap(allocator_, other.allocator_);
+  }
+
+  iterator before_begin() noexcept { return iterator(&head_); }
+
+  const_iterator before_begin() const noexcept {
+    return const_iterator(&head_);
+  }
+
+  const_iterator cbefore_begin() const noexcept {
+    return const_iterator(&head_);
+  }
+
+  iterator begin() noexcept { return iterator(head_.next); }
+
+  iterator end() noexcept { return iterator(); }
+
+  const_iterator begin() const noexcept { return const_iterator(head_.next); }
+
+  const_iterator end() const noexcept { return const_iterator(); }
+
+  const_iterator cbegin() const noexcept { return const_iterator(head_.next); }
+
+  const_iterator cend() const noexcept { return const_iterator(); }
+
+ private:
+  using NodeAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+  ForwardListNodeBase head_;
+  NodeAlloc allocator_;
+
+  template <typename... Args>
+  Node* CreateNode(Args&&... args) {
+    Node* node = NodeTraits::allocate(allocator_, 1);
+    try {
+      NodeTraits::construct(allocator_, node, std::in_place,
+                            std::forward<Args>(args)...);
+    } catch (...) {
+      NodeTraits::deallocate(allocator_, node, 1);
+      throw;
+    }
+    return node;
+  }
+
+  void DestroyNode(Node* node) noexcept {
+    NodeTraits::destroy(allocator_, node);
+    NodeTraits::deallocate(allocator_, node, 1);
+  }
+
+  void DestroyChain(ForwardListNodeBase* node) noexcept {
+    while (node) {
+      ForwardListNodeBase* next = node->next;
+      DestroyNode(static_cast<Node*>(node));
+      node = next;
+    }
+  }
+
+  // Whether other's nodes may be freed through this list's allocator.
+  bool SharesNodes(const forward_list& other) const noexcept {
+    return NodeTraits::is_always_equal::value ||
+           allocator_ == other.allocator_;
+  }
+
+  static const value_type& Value(const ForwardListNodeBase* node) noexcept {
+    return static_cast<const Node*>(node)->data;
+  }
+
+  void PrependChain(ForwardListNodeBase& chain) noexcept {
+    if (!chain.next) {
+      return;
+    }
+    ForwardListNodeBase* last = chain.next;
+    while (last->next) {
+      last = last->next;
+    }
+    last->next = head_.next;
+    head_.next = chain.next;
+    chain.next = nullptr;
+  }
+
+  // Moves the sorted chain after from into the sorted chain after into,
+  // one node per step, so both chains stay whole if a comparison throws.
+  // Equal elements of into stay first.
+  static void MergeChains(ForwardListNodeBase& into,
+                          ForwardListNodeBase& from) {
+    ForwardListNodeBase* prev = &into;
+    while (ForwardListNodeBase* node = from.next) {
+      while (prev->next && !(Value(node) < Value(prev->next))) {
+        prev = prev->next;
+      }
+      from.next = node->next;
+      node->next = prev->next;
+      prev->next = node;
+      prev = node;
+    }
+  }
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINER_SRC_S21_FORWARD_LIST_H_
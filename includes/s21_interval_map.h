@@ -0,0 +1,216 @@
+#ifndef S21_CONTAINER_SRC_S21_INTERVAL_MAP_H_
+#define S21_CONTAINER_SRC_S21_INTERVAL_MAP_H_
+
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "s21_tree.h"
+#include "s21_vector.h"
+
+namespace s21 {
+
+// Multimap from closed intervals [low, high] to values. Entries are ordered
+// by (low, high) and every node also keeps the largest high end in its
+// subtree, which lets overlap queries skip subtrees that end too early.
+// Reporting k overlaps takes O(min(n, (k + 1) log n)): every subtree that
+// is entered holds a reported interval or the one that ends the walk, but
+// reaching each of them may cost a root-to-leaf path.
+//
+// The subtree maxima are updated in noexcept code, so a Key copy that
+// throws there ends in std::terminate. They are also computed without a
+// comparator instance, so Compare must be stateless.
+template <typename Key, typename Tp, typename Compare = std::less<Key>,
+          typename Alloc = std::allocator<std::pair<std::pair<Key, Key>, Tp>>>
+class interval_map {
+  static_assert(std::is_empty<Compare>::value,
+                "interval_map needs a stateless Compare");
+
+ public:
+  using key_type = Key;
+  using interval_type = std::pair<Key, Key>;
+  using mapped_type = Tp;
+  using value_type = std::pair<interval_type, mapped_type>;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+
+ private:
+  struct IntervalLess {
+    bool operator()(const interval_type& lhs, const interval_type& rhs) const {
+      return comp(lhs.first, rhs.first) ||
+             (!comp(rhs.first, lhs.first) && comp(lhs.second, rhs.second));
+    }
+
+    Compare comp;
+  };
+
+  // Augmentation policies are stateless, so this one compares with a
+  // default-constructed Compare; the static_assert above makes that the
+  // same order the tree and the overlap walk use.
+  struct MaxHigh {
+    using value_type = std::optional<Key>;
+    static constexpr bool kNothrowCopy =
+        std::is_nothrow_copy_constructible<Key>::value;
+
+    static value_type identity() noexcept { return std::nullopt; }
+    static value_type lift(const interval_map::value_type& v) noexcept(
+        kNothrowCopy) {
+      return v.first.second;
+    }
+    static value_type combine(const value_type& lhs,
+                              const value_type& rhs) noexcept(kNothrowCopy) {
+      if (!lhs || (rhs && Compare()(*lhs, *rhs))) {
+        return rhs;
+      }
+      return lhs;
+    }
+  };
+
+  using base_tree =
+      RBTree<interval_type, value_type, KeyGetters::SelectFirst<value_type>,
+             IntervalLess, Alloc, false, MaxHigh>;
+
+  class tree : public base_tree {
+   public:
+    using BasePtr = typename base_tree::BasePtr;
+    using NodePtr = typename base_tree::NodePtr;
+
+    const Compare& KeyLess() const noexcept { return this->KeyCompare().comp; }
+
+    template <typename Func>
+    void ForEachOverlap(const Key& low, const Key& high, Func& func) const {
+      ForEachOverlap(this->Root(), low, high, func);
+    }
+
+   private:
+    // Walks in key order; only the left spine is recursive.
+    template <typename Func>
+    void ForEachOverlap(BasePtr node, const Key& low, const Key& high,
+                        Func& func) const {
+      const Compare& less = KeyLess();
+      while (node && !less(*static_cast<NodePtr>(node)->aggregate, low)) {
+        ForEachOverlap(node->left, low, high, func);
+        const interval_type& interval =
+            static_cast<NodePtr>(node)->m_data.first;
+        if (less(high, interval.first)) {
+          return;
+        }
+        if (!less(interval.second, low)) {
+          func(node);
+        }
+        node = node->right;
+      }
+    }
+  };
+
+ public:
+  using iterator = typename tree::iterator;
+  using const_iterator = typename tree::const_iterator;
+  using size_type = typename tree::size_type;
+  using allocator_type = Alloc;
+
+  interval_map() = default;
+
+  interval_map(std::initializer_list<value_type> const& items) {
+    for (auto& item : items) {
+      insert(item);
+    }
+  }
+
+  interval_map(const interval_map& other) : tree_(other.tree_) {}
+
+  interval_map(interval_map&& other) noexcept : tree_(std::move(other.tree_)) {}
+
+  ~interval_map() = default;
+
+  interval_map& operator=(interval_map&& other) noexcept {
+    tree_ = std::move(other.tree_);
+    return *this;
+  }
+
+  interval_map& operator=(const interval_map& other) {
+    tree_ = other.tree_;
+    return *this;
+  }
+
+  void clear() { tree_.clear(); }
+
+  bool empty() const noexcept { return tree_.empty(); }
+
+  size_type size() const noexcept { return tree_.size(); }
+
+  size_type max_size() const noexcept { return tree_.max_size(); }
+
+  iterator insert(const value_type& value) {
+    if (tree_.KeyLess()(value.first.second, value.first.first)) {
+      throw std::invalid_argument("Interval ends before it starts");
+    }
+    return tree_.insert_equal(value).first;
+  }
+
+  iterator insert(const Key& low, const Key& high, const Tp& obj) {
+    return insert(value_type(interval_type(low, high), obj));
+  }
+
+  void erase(iterator pos) { tree_.erase(pos); }
+
+  void swap(interval_map& other) noexcept { tree_.swap(other.tree_); }
+
+  // Calls func(iterator) for every entry whose interval shares a point with
+  // [low, high], in key order, in O(min(n, (k + 1) log n)) for k entries.
+  template <typename Func>
+  void for_each_overlapping(const Key& low, const Key& high, Func func) {
+    auto visit = [&func](typename tree::BasePtr node) { func(iterator(node)); };
+    tree_.ForEachOverlap(low, high, visit);
+  }
+
+  template <typename Func>
+  void for_each_overlapping(const Key& low, const Key& high,
+                            Func func) const {
+    auto visit = [&func](typename tree::BasePtr node) {
+      func(const_iterator(node));
+    };
+    tree_.ForEachOverlap(low, high, visit);
+  }
+
+  vector<iterator> overlapping(const Key& low, const Key& high) {
+    vector<iterator> found;
+    for_each_overlapping(low, high,
+                         [&found](iterator it) { found.push_back(it); });
+    return found;
+  }
+
+  vector<const_iterator> overlapping(const Key& low, const Key& high) const {
+    vector<const_iterator> found;
+    for_each_overlapping(low, high,
+                         [&found](const_iterator it) { found.push_back(it); });
+    return found;
+  }
+
+  vector<iterator> overlapping(const Key& point) {
+    return overlapping(point, point);
+  }
+
+  vector<const_iterator> overlapping(const Key& point) const {
+    return overlapping(point, point);
+  }
+
+  iterator begin() noexcept { return tree_.begin(); }
+
+  const_iterator begin() const noexcept { return tree_.cbegin(); }
+
+  const_iterator cbegin() const noexcept { return tree_.cbegin(); }
+
+  iterator end() noexcept { return tree_.end(); }
+
+  const_iterator end() const noexcept { return tree_.cend(); }
+
+  const_iterator cend() const noexcept { return tree_.cend(); }
+
+ private:
+  tree tree_{};
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINER_SRC_S21_INTERVAL_MAP_H_
@@ -1,21 +1,27 @@
 #ifndef S21_CONTAINER_SRC_S21_LIST_H_
 #define S21_CONTAINER_SRC_S21_LIST_H_
 
+#include <cassert>
 #include <initializer_list>
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
 namespace s21 {
 
 struct ListNodeBase {
   ListNodeBase() noexcept : prev(this), next(this) {}
 
-  ListNodeBase(ListNodeBase* const o_prev, ListNodeBase* const o_next) noexcept
-      : prev(o_prev), next(o_next) {
-    prev->next = next->prev = this;
+  void hook(ListNodeBase* const pos) noexcept {
+    prev = pos->prev;
+    next = pos;
+    pos->prev->next = this;
+    pos->prev = this;
   }
 
-  virtual ~ListNodeBase() noexcept {
+  void unhook() noexcept {
     prev->next = next;
     next->prev = prev;
   }
@@ -26,11 +32,11 @@ struct ListNodeBase {
 
 template <typename Tp>
 struct ListNode : public ListNodeBase {
+  template <typename... Args>
+  explicit ListNode(std::in_place_t, Args&&... args)
+      : data(std::forward<Args>(args)...) {}
+
   Tp data;
-  ListNode() = default;
-  ListNode(ListNodeBase* const o_prev, ListNodeBase* const o_next,
-           const Tp& o_data)
-      : ListNodeBase(o_prev, o_next), data(o_data) {}
 };
 
 template <typename Tp>
@@ -152,8 +158,13 @@ struct ListConstIterator {
   const ListNodeBase* node;
 };
 
-template <typename Tp>
+template <typename Tp, typename Alloc = std::allocator<Tp>>
 class list {
+  template <typename InputIt>
+  using RequireInputIter = std::enable_if_t<std::is_convertible<
+      typename std::iterator_traits<InputIt>::iterator_category,
+      std::input_iterator_tag>::value>;
+
  public:
   using value_type = Tp;
   using reference = Tp&;
@@ -164,8 +175,9 @@ class list {
   using iterator = ListIterator<value_type>;
   using const_iterator = ListConstIterator<value_type>;
   using size_type = size_t;
+  using allocator_type = Alloc;
 
-  list() : base_(new Node()) {}
+  list() = default;
 
   explicit list(size_type n) : list() {
     for (; n != 0; --n) {
@@ -173,28 +185,30 @@ class list {
     }
   }
 
-  list(std::initializer_list<value_type> const& items) : list() {
-    for (auto& item : items) {
-      push_back(item);
-    }
+  template <typename InputIt, typename = RequireInputIter<InputIt>>
+  list(InputIt first, InputIt last) {
+    insert(cend(), first, last);
   }
 
-  list(const list& other) : list() {
-    for (auto& val : other) {
-      push_back(val);
-    }
-  }
+  list(std::initializer_list<value_type> const& items)
+      : list(items.begin(), items.end()) {}
 
-  list(list&& other) noexcept : size_(other.size_), base_(other.base_) {
-    other.base_ = new Node();
-    other.size_ = 0;
+  list(const list& other)
+      : allocator_(NodeTraits::select_on_container_copy_construction(
+            other.allocator_)) {
+    insert(cend(), other.begin(), other.end());
   }
 
-  ~list() {
-    clear();
-    delete base_;
+  list(list&& other) noexcept : allocator_(std::move(other.allocator_)) {
+    std::swap(base_.prev, other.base_.prev);
+    std::swap(base_.next, other.base_.next);
+    std::swap(size_, other.size_);
+    FixSentinel();
+    other.FixSentinel();
   }
 
+  ~list() { clear(); }
+
   list& operator=(const list& other) {
     if (this != &other) {
       list tmp(other);
@@ -211,19 +225,22 @@ class list {
     return *this;
   }
 
-  void clear() {
-    while (!empty()) {
-      ListNodeBase* next = base_->next->next;
-      delete base_->next;
-      base_->next = next;
+  void clear() noexcept {
+    ListNodeBase* node = base_.next;
+    while (node != &base_) {
+      ListNodeBase* next = node->next;
+      DestroyNode(static_cast<Node*>(node));
+      node = next;
     }
+    base_.prev = base_.next = &base_;
     size_ = 0;
   }
 
-  bool empty() const noexcept { return base_ == base_->next; }
+  bool empty() const noexcept { return &base_ == base_.next; }
 
   void erase(iterator pos) {
-    delete pos.node;
+    pos.node->unhook();
+    DestroyNode(static_cast<Node*>(pos.node));
     --size_;
   }
 
@@ -231,45 +248,62 @@ class list {
 
   void pop_back() { erase(tail()); }
 
+  // Takes one element of other at a time, so a throwing comparison leaves
+  // every element in one of the two lists. Nodes are relinked only when
+  // this list's allocator can free them; otherwise the value is moved.
   void merge(list& other) {
     if (this == &other) {
       return;
     }
-    list tmp(size() + other.size());
-    auto it_tmp = tmp.begin();
-    for (;;) {
-      if (empty() && other.empty()) {
-        break;
-      } else if (other.empty() || front() < other.front()) {
-        *it_tmp = std::move(front());
-        pop_front();
+    const bool shares_nodes = SharesNodes(other);
+    ListNodeBase* node = base_.next;
+    while (!other.empty()) {
+      ListNodeBase* other_node = other.base_.next;
+      if (node == &base_ || *iterator(other_node) < *iterator(node)) {
+        if (shares_nodes) {
+          other_node->unhook();
+          other_node->hook(node);
+          ++size_;
+          --other.size_;
+        } else {
+          emplace(const_iterator(node), std::move(other.front()));
+          other.pop_front();
+        }
       } else {
-        *it_tmp = std::move(other.front());
-        other.pop_front();
+        node = node->next;
       }
-      it_tmp++;
     }
-    swap(tmp);
   }
 
+  // Between lists whose allocators cannot free each other's nodes the
+  // values are moved over and other is cleared instead.
   void splice(const_iterator pos, list& other) {
+    if (other.empty()) {
+      return;
+    }
+    if (!SharesNodes(other)) {
+      insert(pos, std::make_move_iterator(other.begin()),
+             std::make_move_iterator(other.end()));
+      other.clear();
+      return;
+    }
     ListNodeBase* node = pos.const_cast_().node;
 
-    node->prev->next = other.base_->next;
-    other.base_->next->prev = node->prev;
+    node->prev->next = other.base_.next;
+    other.base_.next->prev = node->prev;
 
-    node->prev = other.base_->prev;
-    other.base_->prev->next = node;
+    node->prev = other.base_.prev;
+    other.base_.prev->next = node;
 
-    other.base_->next = other.base_;
-    other.base_->prev = other.base_;
+    other.base_.next = &other.base_;
+    other.base_.prev = &other.base_;
 
     size_ += other.size_;
     other.size_ = 0;
   }
 
   void reverse() noexcept {
-    std::swap(base_->next, base_->prev);
+    std::swap(base_.next, base_.prev);
     for (auto it = begin(); it != end(); ++it) {
       std::swap(it.node->next, it.node->prev);
     }
@@ -278,7 +312,7 @@ class list {
   size_type size() const noexcept { return size_; }
 
   size_type max_size() const noexcept {
-    return std::numeric_limits<size_type>::max() / 2 / sizeof(ListNodeBase);
+    return std::numeric_limits<size_type>::max() / 2 / sizeof(Node);
   }
 
   void sort() noexcept { qsort(begin(), tail()); }
@@ -298,39 +332,76 @@ class list {
     }
   }
 
-  reference front() noexcept { return *begin(); }
+  // The list must not be empty: the sentinel holds no value.
+  reference front() noexcept {
+    assert(size_ != 0);
+    return *begin();
+  }
 
-  const_reference front() const noexcept { return *begin(); }
+  const_reference front() const noexcept {
+    assert(size_ != 0);
+    return *begin();
+  }
 
-  reference back() noexcept { return *iterator(base_->prev); }
+  reference back() noexcept {
+    assert(size_ != 0);
+    return *iterator(base_.prev);
+  }
 
-  const_reference back() const noexcept { return *const_iterator(base_->prev); }
+  const_reference back() const noexcept {
+    assert(size_ != 0);
+    return *const_iterator(base_.prev);
+  }
 
   iterator insert(iterator pos, const_reference value) {
-    ++size_;
-    return iterator(new Node(pos.node->prev, pos.node, value));
+    return emplace(pos, value);
+  }
+
+  iterator insert(iterator pos, value_type&& value) {
+    return emplace(pos, std::move(value));
+  }
+
+  // The new nodes are linked into a detached chain first and spliced in with
+  // a single relink, so a throwing constructor leaves the list untouched.
+  template <typename InputIt, typename = RequireInputIter<InputIt>>
+  iterator insert(const_iterator pos, InputIt first, InputIt last) {
+    ListNodeBase chain;
+    size_type count = 0;
+    try {
+      for (; first != last; ++first, ++count) {
+        CreateNode(*first)->hook(&chain);
+      }
+    } catch (...) {
+      DestroyChain(chain);
+      throw;
+    }
+    return SpliceChain(pos, chain, count);
+  }
+
+  iterator insert(const_iterator pos,
+                  std::initializer_list<value_type> const& items) {
+    return insert(pos, items.begin(), items.end());
   }
 
   template <typename... Args>
   iterator insert_many(iterator pos, Args&&... args) {
-    ((pos = insert(pos, args), ++pos), ...);
+    ((pos = emplace(pos, std::forward<Args>(args)), ++pos), ...);
     return pos;
   }
 
   template <typename... Args>
   void insert_many_back(Args&&... args) {
-    (push_back(args), ...);
+    (emplace_back(std::forward<Args>(args)), ...);
   }
 
   template <typename... Args>
   void insert_many_front(Args&&... args) {
-    (push_front(args), ...);
+    (emplace_front(std::forward<Args>(args)), ...);
   }
 
-  void push_front(const_reference value) {
-    ++size_;
-    new Node(base_, base_->next, value);
-  }
+  void push_front(const_reference value) { emplace(cbegin(), value); }
+
+  void push_front(value_type&& value) { emplace(cbegin(), std::move(value)); }
 
   template <typename... Args>
   void emplace_back(Args&&... args) {
@@ -344,46 +415,107 @@ class list {
 
   template <typename... Args>
   iterator emplace(const_iterator pos, Args&&... args) {
-    iterator place = pos.const_cast_();
-    auto node_ptr = static_cast<Node*>(::operator new(sizeof(Node)));
-    new (node_ptr) ListNodeBase(ListNodeBase(place.node->prev, place.node));
-    new (&node_ptr->data) value_type(std::forward<Args>(args)...);
+    Node* node = CreateNode(std::forward<Args>(args)...);
+    node->hook(pos.const_cast_().node);
     ++size_;
-    return iterator(node_ptr);
+    return iterator(node);
   }
 
   void swap(list& other) noexcept {
-    std::swap(base_, other.base_);
+    std::swap(base_.prev, other.base_.prev);
+    std::swap(base_.next, other.base_.next);
     std::swap(size_, other.size_);
+    std::swap(allocator_, other.allocator_);
+    FixSentinel();
+    other.FixSentinel();
   }
 
-  void push_back(const_reference value) {
-    ++size_;
-    new Node(base_->prev, base_, value);
-  }
+  void push_back(const_reference value) { emplace(cend(), value); }
 
-  iterator begin() noexcept {
-    if (!base_) {
-      return iterator();
-    }
-    return iterator(base_->next);
-  }
+  void push_back(value_type&& value) { emplace(cend(), std::move(value)); }
+
+  iterator begin() noexcept { return iterator(base_.next); }
 
-  iterator end() noexcept { return iterator(base_); }
+  iterator end() noexcept { return iterator(&base_); }
 
-  const_iterator begin() const noexcept { return const_iterator(base_->next); }
+  const_iterator begin() const noexcept { return const_iterator(base_.next); }
 
-  const_iterator end() const noexcept { return const_iterator(base_); }
+  const_iterator end() const noexcept { return const_iterator(&base_); }
 
-  const_iterator cbegin() const noexcept { return const_iterator(base_->next); }
+  const_iterator cbegin() const noexcept { return const_iterator(base_.next); }
 
-  const_iterator cend() const noexcept { return const_iterator(base_); }
+  const_iterator cend() const noexcept { return const_iterator(&base_); }
 
  private:
+  using NodeAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+  ListNodeBase base_;
   size_type size_{};
-  ListNodeBase* base_;
+  NodeAlloc allocator_;
 
-  iterator tail() noexcept { return iterator(base_->prev); }
+  // The only place nodes come from: one allocation, with the whole node
+  // constructed in place and its value built from the forwarded arguments.
+  template <typename... Args>
+  Node* CreateNode(Args&&... args) {
+    Node* node = NodeTraits::allocate(allocator_, 1);
+    try {
+      NodeTraits::construct(allocator_, node, std::in_place,
+                            std::forward<Args>(args)...);
+    } catch (...) {
+      NodeTraits::deallocate(allocator_, node, 1);
+      throw;
+    }
+    return node;
+  }
+
+  void DestroyNode(Node* node) noexcept {
+    NodeTraits::destroy(allocator_, node);
+    NodeTraits::deallocate(allocator_, node, 1);
+  }
+
+  // Whether other's nodes may be freed through this list's allocator.
+  bool SharesNodes(const list& other) const noexcept {
+    return NodeTraits::is_always_equal::value ||
+           allocator_ == other.allocator_;
+  }
+
+  void DestroyChain(ListNodeBase& chain) noexcept {
+    ListNodeBase* node = chain.next;
+    while (node != &chain) {
+      ListNodeBase* next = node->next;
+      DestroyNode(static_cast<Node*>(node));
+      node = next;
+    }
+  }
+
+  iterator SpliceChain(const_iterator pos, ListNodeBase& chain,
+                       size_type count) noexcept {
+    ListNodeBase* node = pos.const_cast_().node;
+    if (count == 0) {
+      return iterator(node);
+    }
+    ListNodeBase* first = chain.next;
+    first->prev = node->prev;
+    node->prev->next = first;
+    chain.prev->next = node;
+    node->prev = chain.prev;
+    size_ += count;
+    return iterator(first);
+  }
+
+  iterator tail() noexcept { return iterator(base_.prev); }
+
+  // After the sentinel's links were copied from another list the boundary
+  // nodes still point at the old sentinel.
+  void FixSentinel() noexcept {
+    if (size_ == 0) {
+      base_.prev = base_.next = &base_;
+    } else {
+      base_.next->prev = base_.prev->next = &base_;
+    }
+  }
 
   void qsort(iterator left, iterator right) noexcept {
     if (left == right || left == end() || right == end() || left == tail()) {
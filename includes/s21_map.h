@@ -1,13 +1,24 @@
 #ifndef S21_CONTAINER_SRC_S21_MAP_H_
 #define S21_CONTAINER_SRC_S21_MAP_H_
 
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 #include "s21_tree.h"
 #include "s21_vector.h"
 
 namespace s21 {
 
-template <typename Key, typename Tp, typename Compare = std::less<Key>>
+template <typename Key, typename Tp, typename Compare = std::less<Key>,
+          typename Alloc = std::allocator<std::pair<Key, Tp>>,
+          bool OrderStatistic = false, typename Augment = Augments::None>
 class map {
+  template <typename InputIt>
+  using RequireInputIter = std::enable_if_t<std::is_convertible<
+      typename std::iterator_traits<InputIt>::iterator_category,
+      std::input_iterator_tag>::value>;
+
  public:
   using key_type = Key;
   using mapped_type = Tp;
@@ -15,20 +26,47 @@ class map {
   using reference = value_type&;
   using const_reference = const value_type&;
   using tree = RBTree<key_type, value_type, KeyGetters::SelectFirst<value_type>,
-                      Compare>;
-  using iterator = typename tree::iterator;
+                      Compare, Alloc, OrderStatistic, Augment>;
+
+  // Mapped values may feed the aggregates, so a map with an Augment hands
+  // them out read-only; insert_or_assign() and modify() change them and
+  // keep the aggregates up to date.
+  static constexpr bool kMutableMapped =
+      std::is_same<Augment, Augments::None>::value;
+
+  using mapped_reference =
+      std::conditional_t<kMutableMapped, mapped_type&, const mapped_type&>;
+  using iterator =
+      std::conditional_t<kMutableMapped, typename tree::iterator,
+                         typename tree::const_iterator>;
   using const_iterator = typename tree::const_iterator;
+  using reverse_iterator =
+      std::conditional_t<kMutableMapped, typename tree::reverse_iterator,
+                         typename tree::const_reverse_iterator>;
+  using const_reverse_iterator = typename tree::const_reverse_iterator;
   using size_type = typename tree::size_type;
+  using difference_type = typename tree::difference_type;
+  using allocator_type = Alloc;
+  using node_type = typename tree::node_type;
+  using insert_return_type = RBTreeInsertReturn<iterator, node_type>;
 
   map() = default;
 
   map(std::initializer_list<value_type> const& items) {
-    for (auto& item : items) {
-      tree_.insert_unique(item);
-    }
+    tree_.assign_unique(items.begin(), items.end());
   }
 
-  map(const map& other) noexcept : tree_(other.tree_) {}
+  template <typename InputIt, typename = RequireInputIter<InputIt>>
+  map(InputIt first, InputIt last) {
+    tree_.assign_unique(first, last);
+  }
+
+  template <typename InputIt>
+  map(sorted_unique_t, InputIt first, InputIt last) {
+    tree_.assign_unique(first, last);
+  }
+
+  map(const map& other) : tree_(other.tree_) {}
 
   map(map&& other) noexcept : tree_(std::move(other.tree_)) {}
 
@@ -44,38 +82,26 @@ class map {
     return *this;
   }
 
-  mapped_type& at(const Key& key) {
-    iterator it = tree_.lower_bound(key);
-    if (it == end() || Compare()(key, (*it).first)) {
-      throw std::out_of_range("Missing key in map");
-    }
-    return (*it).second;
+  mapped_reference at(const Key& key) { return at_(*this, key); }
+
+  const mapped_type& at(const Key& key) const { return at_(*this, key); }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  mapped_reference at(const K& key) {
+    return at_(*this, key);
   }
 
-  const mapped_type& at(const Key& key) const {
-    const_iterator it = tree_.lower_bound(key);
-    if (it == end() || Compare()(key, (*it).first)) {
-      throw std::out_of_range("Missing key in map");
-    }
-    return (*it).second;
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  const mapped_type& at(const K& key) const {
+    return at_(*this, key);
   }
 
-  mapped_type& operator[](const Key& key) {
-    iterator it = tree_.lower_bound(key);
-    if (it == end() || Compare()(key, (*it).first)) {
-      auto ins_it = insert(value_type(key, mapped_type())).first;
-      return (*ins_it).second;
-    }
-    return (*it).second;
+  mapped_reference operator[](const Key& key) {
+    return (*try_emplace(key).first).second;
   }
 
-  const mapped_type& operator[](const Key& key) const {
-    const_iterator it = tree_.lower_bound(key);
-    if (it == end() || Compare()(key, (*it).first)) {
-      auto ins_it = insert(value_type(key, mapped_type())).first;
-      return (*ins_it).second;
-    }
-    return (*it).second;
+  mapped_reference operator[](Key&& key) {
+    return (*try_emplace(std::move(key)).first).second;
   }
 
   void clear() { tree_.clear(); }
@@ -86,39 +112,176 @@ class map {
 
   size_type max_size() const noexcept { return tree_.max_size(); }
 
+  // Smallest and largest elements in O(1); not for an empty map.
+  const_reference min() const noexcept { return tree_.min(); }
+
+  const_reference max() const noexcept { return tree_.max(); }
+
+  void pop_front() noexcept { tree_.pop_front(); }
+
+  void pop_back() noexcept { tree_.pop_back(); }
+
   std::pair<iterator, bool> insert(const value_type& value) {
     return tree_.insert_unique(value);
   }
 
+  iterator insert(const_iterator hint, const value_type& value) {
+    return tree_.insert_unique(hint, value);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return tree_.insert_unique(std::move(value));
+  }
+
+  iterator insert(const_iterator hint, value_type&& value) {
+    return tree_.insert_unique(hint, std::move(value));
+  }
+
+  insert_return_type insert(node_type&& handle) {
+    auto res = tree_.insert_unique(std::move(handle));
+    return insert_return_type{res.position, res.inserted, std::move(res.node)};
+  }
+
+  node_type extract(const_iterator pos) noexcept { return tree_.extract(pos); }
+
+  node_type extract(const Key& key) noexcept { return tree_.extract(key); }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return tree_.emplace_hint_unique(hint, std::forward<Args>(args)...);
+  }
+
   template <typename... Args>
   vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
     vector<std::pair<iterator, bool>> inserted;
     std::pair<iterator, bool> ins_pair;
-    ((ins_pair = insert(args), inserted.push_back(ins_pair)), ...);
+    ((ins_pair = insert(std::forward<Args>(args)),
+      inserted.push_back(ins_pair)),
+     ...);
     return inserted;
   }
 
-  void erase(iterator pos) { tree_.erase((*pos).first); }
+  iterator erase(iterator pos) { return tree_.erase(pos); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    return tree_.erase(first, last);
+  }
+
+  size_type erase(const Key& key) { return tree_.erase(key); }
+
+  // Erases the elements pred holds for in one pass over the map.
+  template <typename Pred>
+  size_type erase_if(Pred pred) {
+    return tree_.erase_if(pred);
+  }
 
   void swap(map& other) noexcept { tree_.swap(other.tree_); }
 
   void merge(map& other) { tree_.merge_unique(other.tree_); }
 
+  // Moves the elements with keys not less than key into the returned map;
+  // see RBTree::split() for the cost.
+  map split(const key_type& key) {
+    map upper;
+    upper.tree_ = tree_.split(key);
+    return upper;
+  }
+
+  // Appends other, whose keys must all sort after ours, in O(log n). Throws
+  // std::invalid_argument when they do not.
+  void join(map& other) { tree_.join_unique(other.tree_); }
+
   std::pair<iterator, bool> insert(const Key& key, const Tp& obj) {
     return tree_.insert_unique(value_type(key, obj));
   }
 
-  std::pair<iterator, bool> insert_or_assign(const Key& key, const Tp& obj) {
-    iterator it = tree_.lower_bound(key);
-    if (it == end() || Compare()(key, (*it).first)) {
-      tree_.insert_unique(value_type(key, obj));
-      return std::make_pair(it, true);
+  // try_emplace() and insert_or_assign() search once; the mapped value is
+  // only constructed when the key is new.
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    return tree_.try_emplace_unique(
+        key, std::piecewise_construct, std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+    return tree_.try_emplace_unique(
+        key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  iterator try_emplace(const_iterator hint, const Key& key, Args&&... args) {
+    return tree_.try_emplace_hint_unique(
+        hint, key, std::piecewise_construct, std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  iterator try_emplace(const_iterator hint, Key&& key, Args&&... args) {
+    return tree_.try_emplace_hint_unique(
+        hint, key, std::piecewise_construct,
+        std::forward_as_tuple(std::move(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj) {
+    std::pair<iterator, bool> res = try_emplace(key, std::forward<M>(obj));
+    if (!res.second) {
+      Assign(res.first, std::forward<M>(obj));
+    }
+    return res;
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(Key&& key, M&& obj) {
+    std::pair<iterator, bool> res =
+        try_emplace(std::move(key), std::forward<M>(obj));
+    if (!res.second) {
+      Assign(res.first, std::forward<M>(obj));
     }
-    (*it).second = obj;
-    return std::pair<iterator, bool>(it, false);
+    return res;
+  }
+
+  // Calls func with the mapped value at pos to change it in place; the
+  // aggregates that cover it are brought up to date in O(log n).
+  template <typename Func>
+  void modify(const_iterator pos, Func func) {
+    tree_.modify(pos, [&func](value_type& value) { func(value.second); });
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return tree_.emplace_unique(std::forward<Args>(args)...);
+  }
+
+  bool contains(const Key& key) const noexcept { return tree_.contains(key); }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  bool contains(const K& key) const noexcept {
+    return tree_.contains(key);
+  }
+
+  size_type rank(const Key& key) const noexcept { return tree_.rank(key); }
+
+  iterator select(size_type pos) noexcept { return tree_.select(pos); }
+
+  const_iterator select(size_type pos) const noexcept {
+    return tree_.select(pos);
   }
 
-  bool contains(const Key& key) const noexcept { return tree_.count(key) != 0; }
+  difference_type distance(const_iterator first,
+                           const_iterator last) const noexcept {
+    return tree_.distance(first, last);
+  }
+
+  template <typename Aug = Augment>
+  typename Aug::value_type aggregate(const Key& lower,
+                                     const Key& upper) const noexcept {
+    return tree_.aggregate(lower, upper);
+  }
 
   iterator begin() noexcept { return tree_.begin(); }
 
@@ -132,10 +295,46 @@ class map {
 
   const_iterator cend() const noexcept { return tree_.cend(); }
 
+  reverse_iterator rbegin() noexcept { return tree_.rbegin(); }
+
+  const_reverse_iterator rbegin() const noexcept { return tree_.rbegin(); }
+
+  const_reverse_iterator crbegin() const noexcept { return tree_.rbegin(); }
+
+  reverse_iterator rend() noexcept { return tree_.rend(); }
+
+  const_reverse_iterator rend() const noexcept { return tree_.rend(); }
+
+  const_reverse_iterator crend() const noexcept { return tree_.rend(); }
+
  private:
   tree tree_{};
+
+  template <typename M>
+  void Assign(const_iterator pos, M&& obj) {
+    tree_.modify(pos, [&obj](value_type& value) {
+      value.second = std::forward<M>(obj);
+    });
+  }
+
+  template <typename Self, typename K>
+  static auto& at_(Self& self, const K& key) {
+    auto it = self.tree_.find(key);
+    if (it == self.tree_.end()) {
+      throw std::out_of_range("Missing key in map");
+    }
+    return (*it).second;
+  }
 };
 
+// Pass rvalues to join in O(log n); lvalue arguments are copied first.
+template <typename K, typename T, typename C, typename A, bool S, typename G>
+map<K, T, C, A, S, G> join(map<K, T, C, A, S, G> lhs,
+                           map<K, T, C, A, S, G> rhs) {
+  lhs.join(rhs);
+  return lhs;
+}
+
 }  // namespace s21
 
 #endif  // S21_CONTAINER_SRC_S21_MAP_H_
\ No newline at end of file
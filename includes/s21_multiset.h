@@ -6,28 +6,52 @@
 
 namespace s21 {
 
-template <typename Key, typename Compare = std::less<Key>>
+template <typename Key, typename Compare = std::less<Key>,
+          typename Alloc = std::allocator<Key>, bool OrderStatistic = false,
+          typename Augment = Augments::None>
 class multiset {
+  template <typename InputIt>
+  using RequireInputIter = std::enable_if_t<std::is_convertible<
+      typename std::iterator_traits<InputIt>::iterator_category,
+      std::input_iterator_tag>::value>;
+
  public:
   using key_type = Key;
   using value_type = Key;
   using reference = Key&;
   using const_reference = const Key&;
-  using tree =
-      RBTree<key_type, value_type, KeyGetters::Identity<value_type>, Compare>;
+  using tree = RBTree<key_type, value_type, KeyGetters::Identity<value_type>,
+                      Compare, Alloc, OrderStatistic, Augment>;
   using iterator = typename tree::iterator;
   using const_iterator = typename tree::const_iterator;
+  using reverse_iterator = typename tree::reverse_iterator;
+  using const_reverse_iterator = typename tree::const_reverse_iterator;
   using size_type = typename tree::size_type;
+  using difference_type = typename tree::difference_type;
+  using allocator_type = Alloc;
+  using node_type = typename tree::node_type;
 
   multiset() = default;
 
   multiset(std::initializer_list<value_type> const& items) {
-    for (auto& item : items) {
-      insert(item);
-    }
+    tree_.assign_equal(items.begin(), items.end());
+  }
+
+  template <typename InputIt, typename = RequireInputIter<InputIt>>
+  multiset(InputIt first, InputIt last) {
+    tree_.assign_equal(first, last);
+  }
+
+  template <typename InputIt>
+  multiset(sorted_equivalent_t, InputIt first, InputIt last) {
+    tree_.assign_equal(first, last);
   }
 
-  multiset(const multiset& other) noexcept : tree_(other.tree_) {}
+  // The result of lhs op rhs; see set_union() and friends below.
+  multiset(SetOperation op, const multiset& lhs, const multiset& rhs)
+      : tree_(op, lhs.tree_, rhs.tree_) {}
+
+  multiset(const multiset& other) : tree_(other.tree_) {}
 
   multiset(multiset&& other) noexcept : tree_(std::move(other.tree_)) {}
 
@@ -51,48 +75,193 @@ class multiset {
 
   size_type max_size() const noexcept { return tree_.max_size(); }
 
+  // Smallest and largest elements in O(1); not for an empty multiset.
+  const_reference min() const noexcept { return tree_.min(); }
+
+  const_reference max() const noexcept { return tree_.max(); }
+
+  void pop_front() noexcept { tree_.pop_front(); }
+
+  void pop_back() noexcept { tree_.pop_back(); }
+
   std::pair<iterator, bool> insert(const value_type& value) {
     return tree_.insert_equal(value);
   }
 
+  iterator insert(const_iterator hint, const value_type& value) {
+    return tree_.insert_equal(hint, value);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return tree_.insert_equal(std::move(value));
+  }
+
+  iterator insert(const_iterator hint, value_type&& value) {
+    return tree_.insert_equal(hint, std::move(value));
+  }
+
+  iterator insert(node_type&& handle) {
+    return tree_.insert_equal(std::move(handle));
+  }
+
+  node_type extract(const_iterator pos) noexcept { return tree_.extract(pos); }
+
+  node_type extract(const Key& key) noexcept { return tree_.extract(key); }
+
+  template <typename... Args>
+  iterator emplace(Args&&... args) {
+    return tree_.emplace_equal(std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return tree_.emplace_hint_equal(hint, std::forward<Args>(args)...);
+  }
+
   template <typename... Args>
   vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
     vector<std::pair<iterator, bool>> inserted;
     std::pair<iterator, bool> ins_pair;
-    ((ins_pair = insert(args), inserted.push_back(ins_pair)), ...);
+    ((ins_pair = insert(std::forward<Args>(args)),
+      inserted.push_back(ins_pair)),
+     ...);
     return inserted;
   }
 
-  void erase(iterator pos) { tree_.erase(*pos); }
+  iterator erase(iterator pos) { return tree_.erase(pos); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    return tree_.erase(first, last);
+  }
+
+  size_type erase(const Key& key) { return tree_.erase(key); }
+
+  // Erases the elements pred holds for in one pass over the multiset.
+  template <typename Pred>
+  size_type erase_if(Pred pred) {
+    return tree_.erase_if(pred);
+  }
 
   void swap(multiset& other) noexcept { tree_.swap(other.tree_); }
 
   void merge(multiset& other) { tree_.merge_equal(other.tree_); }
 
+  // Moves the elements with keys not less than key into the returned multiset;
+  // see RBTree::split() for the cost.
+  multiset split(const key_type& key) {
+    multiset upper;
+    upper.tree_ = tree_.split(key);
+    return upper;
+  }
+
+  // Appends other, whose keys must all sort after ours, in O(log n). Throws
+  // std::invalid_argument when they do not.
+  void join(multiset& other) { tree_.join_equal(other.tree_); }
+
   iterator find(const Key& key) noexcept { return tree_.find(key); }
 
   const_iterator find(const Key& key) const noexcept { return tree_.find(key); }
 
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  iterator find(const K& key) noexcept {
+    return tree_.find(key);
+  }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  const_iterator find(const K& key) const noexcept {
+    return tree_.find(key);
+  }
+
   size_type count(const Key& key) const noexcept { return tree_.count(key); }
 
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  size_type count(const K& key) const noexcept {
+    return tree_.count(key);
+  }
+
   std::pair<iterator, iterator> equal_range(const Key& key) {
     return tree_.equal_range(key);
   }
 
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  std::pair<iterator, iterator> equal_range(const K& key) {
+    return tree_.equal_range(key);
+  }
+
   iterator lower_bound(const Key& key) { return tree_.lower_bound(key); }
 
   const_iterator lower_bound(const Key& key) const {
     return tree_.lower_bound(key);
   }
 
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  iterator lower_bound(const K& key) {
+    return tree_.lower_bound(key);
+  }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  const_iterator lower_bound(const K& key) const {
+    return tree_.lower_bound(key);
+  }
+
   iterator upper_bound(const Key& key) { return tree_.upper_bound(key); }
 
   const_iterator upper_bound(const Key& key) const {
     return tree_.upper_bound(key);
   }
 
-  bool contains(const Key& key) const noexcept {
-    return tree_.find(key) != tree_.end();
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  iterator upper_bound(const K& key) {
+    return tree_.upper_bound(key);
+  }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  const_iterator upper_bound(const K& key) const {
+    return tree_.upper_bound(key);
+  }
+
+  bool contains(const Key& key) const noexcept { return tree_.contains(key); }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  bool contains(const K& key) const noexcept {
+    return tree_.contains(key);
+  }
+
+  size_type rank(const Key& key) const noexcept { return tree_.rank(key); }
+
+  iterator select(size_type pos) noexcept { return tree_.select(pos); }
+
+  const_iterator select(size_type pos) const noexcept {
+    return tree_.select(pos);
+  }
+
+  difference_type distance(const_iterator first,
+                           const_iterator last) const noexcept {
+    return tree_.distance(first, last);
+  }
+
+  template <typename Aug = Augment>
+  typename Aug::value_type aggregate(const Key& lower,
+                                     const Key& upper) const noexcept {
+    return tree_.aggregate(lower, upper);
+  }
+
+  // In-place set operations; nodes of this multiset are reused.
+  void union_with(const multiset& other) {
+    tree_.apply_set_operation(SetOperation::kUnion, other.tree_);
+  }
+
+  void intersect_with(const multiset& other) {
+    tree_.apply_set_operation(SetOperation::kIntersection, other.tree_);
+  }
+
+  void difference_with(const multiset& other) {
+    tree_.apply_set_operation(SetOperation::kDifference, other.tree_);
+  }
+
+  void symmetric_difference_with(const multiset& other) {
+    tree_.apply_set_operation(SetOperation::kSymmetricDifference,
+                              other.tree_);
   }
 
   iterator begin() noexcept { return tree_.begin(); }
@@ -107,10 +276,56 @@ class multiset {
 
   const_iterator cend() const noexcept { return tree_.cend(); }
 
+  reverse_iterator rbegin() noexcept { return tree_.rbegin(); }
+
+  const_reverse_iterator rbegin() const noexcept { return tree_.rbegin(); }
+
+  const_reverse_iterator crbegin() const noexcept { return tree_.rbegin(); }
+
+  reverse_iterator rend() noexcept { return tree_.rend(); }
+
+  const_reverse_iterator rend() const noexcept { return tree_.rend(); }
+
+  const_reverse_iterator crend() const noexcept { return tree_.rend(); }
+
  private:
   tree tree_{};
 };
 
+// O(n + m) set operations; with multisets, counts combine as in std.
+
+template <typename K, typename C, typename A, bool S, typename G>
+multiset<K, C, A, S, G> set_union(const multiset<K, C, A, S, G>& lhs,
+                                  const multiset<K, C, A, S, G>& rhs) {
+  return multiset<K, C, A, S, G>(SetOperation::kUnion, lhs, rhs);
+}
+
+template <typename K, typename C, typename A, bool S, typename G>
+multiset<K, C, A, S, G> set_intersection(const multiset<K, C, A, S, G>& lhs,
+                                         const multiset<K, C, A, S, G>& rhs) {
+  return multiset<K, C, A, S, G>(SetOperation::kIntersection, lhs, rhs);
+}
+
+template <typename K, typename C, typename A, bool S, typename G>
+multiset<K, C, A, S, G> set_difference(const multiset<K, C, A, S, G>& lhs,
+                                       const multiset<K, C, A, S, G>& rhs) {
+  return multiset<K, C, A, S, G>(SetOperation::kDifference, lhs, rhs);
+}
+
+template <typename K, typename C, typename A, bool S, typename G>
+multiset<K, C, A, S, G> set_symmetric_difference(
+    const multiset<K, C, A, S, G>& lhs, const multiset<K, C, A, S, G>& rhs) {
+  return multiset<K, C, A, S, G>(SetOperation::kSymmetricDifference, lhs, rhs);
+}
+
+// Pass rvalues to join in O(log n); lvalue arguments are copied first.
+template <typename K, typename C, typename A, bool S, typename G>
+multiset<K, C, A, S, G> join(multiset<K, C, A, S, G> lhs,
+                             multiset<K, C, A, S, G> rhs) {
+  lhs.join(rhs);
+  return lhs;
+}
+
 }  // namespace s21
 
 #endif  // S21_CONTAINER_SRC_S21_MULTISET_H_
\ No newline at end of file
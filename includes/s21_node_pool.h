@@ -0,0 +1,237 @@
+#ifndef S21_CONTAINER_SRC_S21_NODE_POOL_H_
+#define S21_CONTAINER_SRC_S21_NODE_POOL_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace s21 {
+
+// Hands out fixed-size slots carved from contiguous chunks. Every slot can be
+// returned on its own (it goes to an intrusive free list), even when it was
+// handed out as part of a multi-slot allocate(n), and release() gives all
+// chunks back at once.
+class NodePool {
+ public:
+  NodePool(size_t slot_size, size_t chunk_slots) noexcept
+      : slot_size_(RoundUp(slot_size < sizeof(FreeSlot) ? sizeof(FreeSlot)
+                                                        : slot_size)),
+        chunk_slots_(chunk_slots) {}
+
+  NodePool(const NodePool&) = delete;
+  NodePool& operator=(const NodePool&) = delete;
+
+  ~NodePool() { release(); }
+
+  void* allocate(size_t n) {
+    if (n == 1 && free_list_) {
+      FreeSlot* slot = free_list_;
+      free_list_ = slot->next;
+      ++in_use_;
+      return slot;
+    }
+    if (static_cast<size_t>(chunk_end_ - chunk_pos_) < n * slot_size_) {
+      AddChunk(n > chunk_slots_ ? n : chunk_slots_);
+    }
+    void* slots = chunk_pos_;
+    chunk_pos_ += n * slot_size_;
+    in_use_ += n;
+    return slots;
+  }
+
+  void deallocate(void* ptr, size_t n) noexcept {
+    auto bytes = static_cast<unsigned char*>(ptr);
+    for (size_t i = 0; i != n; ++i, bytes += slot_size_) {
+      auto slot = reinterpret_cast<FreeSlot*>(bytes);
+      slot->next = free_list_;
+      free_list_ = slot;
+    }
+    in_use_ -= n;
+  }
+
+  void release() noexcept {
+    while (chunks_) {
+      Chunk* next = chunks_->next;
+      ::operator delete(chunks_);
+      chunks_ = next;
+    }
+    free_list_ = nullptr;
+    chunk_pos_ = chunk_end_ = nullptr;
+    in_use_ = 0;
+  }
+
+  size_t in_use() const noexcept { return in_use_; }
+
+ private:
+  struct FreeSlot {
+    FreeSlot* next;
+  };
+
+  struct alignas(std::max_align_t) Chunk {
+    Chunk* next;
+  };
+
+  static size_t RoundUp(size_t size) noexcept {
+    constexpr size_t kAlign = alignof(std::max_align_t);
+    return (size + kAlign - 1) / kAlign * kAlign;
+  }
+
+  void AddChunk(size_t slots) {
+    auto chunk = static_cast<Chunk*>(
+        ::operator new(sizeof(Chunk) + slots * slot_size_));
+    chunk->next = chunks_;
+    chunks_ = chunk;
+    chunk_pos_ = reinterpret_cast<unsigned char*>(chunk + 1);
+    chunk_end_ = chunk_pos_ + slots * slot_size_;
+  }
+
+  size_t slot_size_;
+  size_t chunk_slots_;
+  size_t in_use_{};
+  Chunk* chunks_{};
+  FreeSlot* free_list_{};
+  unsigned char* chunk_pos_{};
+  unsigned char* chunk_end_{};
+};
+
+// The pools behind one pool_allocator, its copies and its rebinds: one
+// pool per slot size, created on first use.
+class NodePoolGroup {
+ public:
+  NodePoolGroup() = default;
+
+  NodePoolGroup(const NodePoolGroup&) = delete;
+  NodePoolGroup& operator=(const NodePoolGroup&) = delete;
+
+  ~NodePoolGroup() {
+    while (pools_) {
+      Entry* next = pools_->next;
+      delete pools_;
+      pools_ = next;
+    }
+  }
+
+  NodePool* find(size_t slot_size) const noexcept {
+    for (Entry* entry = pools_; entry; entry = entry->next) {
+      if (entry->slot_size == slot_size) {
+        return &entry->pool;
+      }
+    }
+    return nullptr;
+  }
+
+  NodePool& pool(size_t slot_size, size_t chunk_slots) {
+    if (NodePool* found = find(slot_size)) {
+      return *found;
+    }
+    pools_ = new Entry(slot_size, chunk_slots, pools_);
+    return pools_->pool;
+  }
+
+ private:
+  struct Entry {
+    Entry(size_t o_slot_size, size_t chunk_slots, Entry* o_next) noexcept
+        : slot_size(o_slot_size),
+          pool(o_slot_size, chunk_slots),
+          next(o_next) {}
+
+    size_t slot_size;
+    NodePool pool;
+    Entry* next;
+  };
+
+  Entry* pools_{};
+};
+
+// Node allocator for the node based containers. An allocator, its copies
+// and its rebinds (what a container does to get at its node type) share
+// one NodePoolGroup, made when the first of them is constructed, so they
+// all compare equal for good and any of them can free what another
+// allocated. A copy made for a copy-constructed container starts a group
+// of its own, so every container ends up owning its nodes' chunks.
+template <typename Tp, size_t ChunkSlots = 256>
+class pool_allocator {
+ public:
+  using value_type = Tp;
+  using size_type = size_t;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template <typename Up>
+  struct rebind {
+    using other = pool_allocator<Up, ChunkSlots>;
+  };
+
+  pool_allocator() : group_(std::make_shared<NodePoolGroup>()) {}
+
+  // Also serves moves: a moved-from allocator keeps its group, so the
+  // container it stays in can still allocate.
+  pool_allocator(const pool_allocator&) noexcept = default;
+
+  template <typename Up>
+  pool_allocator(const pool_allocator<Up, ChunkSlots>& other) noexcept
+      : group_(other.group_) {}
+
+  pool_allocator& operator=(const pool_allocator&) noexcept = default;
+
+  Tp* allocate(size_type n) {
+    static_assert(alignof(Tp) <= alignof(std::max_align_t),
+                  "Over-aligned types are not supported by the node pool");
+    if (!pool_) {
+      pool_ = &group_->pool(sizeof(Tp), ChunkSlots);
+    }
+    return static_cast<Tp*>(pool_->allocate(n));
+  }
+
+  void deallocate(Tp* ptr, size_type n) noexcept {
+    FindPool()->deallocate(ptr, n);
+  }
+
+  // Drops every chunk of the pool for Tp at once. Only valid once no slot
+  // is in use anymore or when the caller owns all the slots that still are.
+  void release() noexcept {
+    if (NodePool* pool = FindPool()) {
+      pool->release();
+    }
+  }
+
+  size_type in_use() const noexcept {
+    NodePool* pool = FindPool();
+    return pool ? pool->in_use() : 0;
+  }
+
+  pool_allocator select_on_container_copy_construction() const {
+    return pool_allocator();
+  }
+
+  friend bool operator==(const pool_allocator& lhs,
+                         const pool_allocator& rhs) noexcept {
+    return lhs.group_ == rhs.group_;
+  }
+
+  friend bool operator!=(const pool_allocator& lhs,
+                         const pool_allocator& rhs) noexcept {
+    return lhs.group_ != rhs.group_;
+  }
+
+ private:
+  template <typename Up, size_t Slots>
+  friend class pool_allocator;
+
+  // Each allocator object looks its pool up in the group once; copies
+  // inherit the result.
+  NodePool* FindPool() const noexcept {
+    if (!pool_) {
+      pool_ = group_->find(sizeof(Tp));
+    }
+    return pool_;
+  }
+
+  std::shared_ptr<NodePoolGroup> group_;
+  mutable NodePool* pool_{};
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINER_SRC_S21_NODE_POOL_H_
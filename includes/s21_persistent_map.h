@@ -0,0 +1,575 @@
+#ifndef S21_CONTAINER_SRC_S21_PERSISTENT_MAP_H_
+#define S21_CONTAINER_SRC_S21_PERSISTENT_MAP_H_
+
+#include <algorithm>
+#include <atomic>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "s21_tree.h"
+
+namespace s21 {
+
+// Node of a persistent tree. It never points at its parent, so one node can
+// sit in any number of versions at once; refs counts the parents and maps
+// holding it.
+struct PersistentNodeBase {
+  using BasePtr = PersistentNodeBase*;
+  using ColorType = RBTreeNodeColor;
+
+  // A red-black tree is at most 2 log2(n + 1) deep, so a search path or one
+  // pending subtree per level fits a fixed stack for any tree.
+  static constexpr int kMaxDepth = 2 * std::numeric_limits<size_t>::digits;
+
+  std::atomic<size_t> refs;
+  BasePtr link[2];
+  ColorType color;
+};
+
+template <typename Tp>
+struct PersistentNode : public PersistentNodeBase {
+  Tp m_data;
+};
+
+// Forward iterator over one version. Without parent links it keeps the
+// nodes still to visit: the current one on top and below it every ancestor
+// whose left subtree the walk is in. Only the first depth entries are live:
+// end() is an empty stack that is never filled, and copies and comparisons
+// touch the live entries only.
+template <typename Tp>
+struct PersistentMapIterator {
+  using BasePtr = const PersistentNodeBase*;
+  using Node = const PersistentNode<Tp>;
+  using difference_type = ptrdiff_t;
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = Tp;
+  using pointer = const Tp*;
+  using reference = const Tp&;
+
+  PersistentMapIterator() noexcept : depth(0) {}
+
+  PersistentMapIterator(const PersistentMapIterator& other) noexcept
+      : depth(other.depth) {
+    std::copy_n(other.path, depth, path);
+  }
+
+  PersistentMapIterator& operator=(
+      const PersistentMapIterator& other) noexcept {
+    depth = other.depth;
+    std::copy_n(other.path, depth, path);
+    return *this;
+  }
+
+  reference operator*() const noexcept {
+    return static_cast<Node*>(path[depth - 1])->m_data;
+  }
+
+  pointer operator->() const noexcept {
+    return &static_cast<Node*>(path[depth - 1])->m_data;
+  }
+
+  PersistentMapIterator& operator++() noexcept {
+    BasePtr right = path[--depth]->link[1];
+    PushLeftSpine(right);
+    return *this;
+  }
+
+  PersistentMapIterator operator++(int) noexcept {
+    PersistentMapIterator ret(*this);
+    ++*this;
+    return ret;
+  }
+
+  void PushLeftSpine(BasePtr node) noexcept {
+    for (; node; node = node->link[0]) {
+      path[depth++] = node;
+    }
+  }
+
+  friend bool operator==(const PersistentMapIterator& lhs,
+                         const PersistentMapIterator& rhs) noexcept {
+    return lhs.depth == rhs.depth &&
+           (!lhs.depth || lhs.path[lhs.depth - 1] == rhs.path[rhs.depth - 1]);
+  }
+
+  friend bool operator!=(const PersistentMapIterator& lhs,
+                         const PersistentMapIterator& rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+  BasePtr path[PersistentNodeBase::kMaxDepth];
+  int depth;
+};
+
+// Ordered map whose copies share structure. A copy takes O(1) and is a
+// snapshot: later changes to either map never show through in the other.
+// An update copies only the nodes it changes that another version still
+// holds, which is O(log n) of them; nodes this map holds alone are changed
+// in place. Versions may be read, copied and destroyed on any thread, but a
+// map must not be changed while it is being read or copied.
+template <typename Key, typename Tp, typename Compare = std::less<Key>,
+          typename Alloc = std::allocator<std::pair<Key, Tp>>>
+class persistent_map {
+  template <typename InputIt>
+  using RequireInputIter = std::enable_if_t<std::is_convertible<
+      typename std::iterator_traits<InputIt>::iterator_category,
+      std::input_iterator_tag>::value>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = Tp;
+  using value_type = std::pair<key_type, mapped_type>;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+  using iterator = PersistentMapIterator<value_type>;
+  using const_iterator = iterator;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using allocator_type = Alloc;
+
+  persistent_map() = default;
+
+  persistent_map(std::initializer_list<value_type> const& items)
+      : persistent_map() {
+    for (auto& item : items) {
+      insert(item);
+    }
+  }
+
+  template <typename InputIt, typename = RequireInputIter<InputIt>>
+  persistent_map(InputIt first, InputIt last) : persistent_map() {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  // Versions share nodes, so a copy keeps the allocator that can free them
+  // rather than asking for a fresh one.
+  persistent_map(const persistent_map& other) noexcept
+      : root_(Share(other.root_)),
+        size_(other.size_),
+        compare_(other.compare_),
+        allocator_(other.allocator_) {}
+
+  persistent_map(persistent_map&& other) noexcept
+      : root_(other.root_),
+        size_(other.size_),
+        compare_(std::move(other.compare_)),
+        allocator_(std::move(other.allocator_)) {
+    other.root_ = nullptr;
+    other.size_ = 0;
+  }
+
+  ~persistent_map() { Release(root_); }
+
+  persistent_map& operator=(const persistent_map& other) noexcept {
+    persistent_map tmp(other);
+    swap(tmp);
+    return *this;
+  }
+
+  persistent_map& operator=(persistent_map&& other) noexcept {
+    persistent_map tmp(std::move(other));
+    swap(tmp);
+    return *this;
+  }
+
+  const mapped_type& at(const Key& key) const {
+    BasePtr node = FindNode(key);
+    if (!node) {
+      throw std::out_of_range("Missing key in map");
+    }
+    return Data(node).second;
+  }
+
+  const_iterator find(const Key& key) const {
+    const_iterator it;
+    for (BasePtr node = root_; node;) {
+      if (compare_(key, Data(node).first)) {
+        it.path[it.depth++] = node;
+        node = node->link[0];
+      } else if (compare_(Data(node).first, key)) {
+        node = node->link[1];
+      } else {
+        it.path[it.depth++] = node;
+        return it;
+      }
+    }
+    return end();
+  }
+
+  bool contains(const Key& key) const { return FindNode(key) != nullptr; }
+
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  bool empty() const noexcept { return size_ == 0; }
+
+  size_type size() const noexcept { return size_; }
+
+  size_type max_size() const noexcept {
+    return std::numeric_limits<size_type>::max() / 2 / sizeof(Node);
+  }
+
+  void clear() noexcept {
+    Release(root_);
+    root_ = nullptr;
+    size_ = 0;
+  }
+
+  // Return whether the key was new. Elements cannot be changed through an
+  // iterator, so unlike map these give none back.
+  bool insert(const value_type& value) { return Insert(value.first, value); }
+
+  bool insert(value_type&& value) {
+    return Insert(value.first, std::move(value));
+  }
+
+  bool insert(const Key& key, const Tp& obj) { return Insert(key, key, obj); }
+
+  template <typename M>
+  bool insert_or_assign(const Key& key, M&& obj) {
+    return InsertOrAssign(key, std::forward<M>(obj));
+  }
+
+  template <typename M>
+  bool insert_or_assign(Key&& key, M&& obj) {
+    return InsertOrAssign(std::move(key), std::forward<M>(obj));
+  }
+
+  size_type erase(const Key& key) {
+    if (!FindNode(key)) {
+      return 0;
+    }
+    PersistentNodeBase head{};
+    head.link[1] = root_;
+    root_ = nullptr;
+    try {
+      EraseTopDown(&head, key);
+    } catch (...) {
+      SetRoot(head.link[1]);
+      throw;
+    }
+    SetRoot(head.link[1]);
+    --size_;
+    return 1;
+  }
+
+  void swap(persistent_map& other) noexcept {
+    std::swap(root_, other.root_);
+    std::swap(size_, other.size_);
+    std::swap(compare_, other.compare_);
+    std::swap(allocator_, other.allocator_);
+  }
+
+  const_iterator begin() const noexcept {
+    const_iterator it;
+    it.PushLeftSpine(root_);
+    return it;
+  }
+
+  const_iterator end() const noexcept { return const_iterator(); }
+
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  const_iterator cend() const noexcept { return end(); }
+
+ private:
+  using BasePtr = PersistentNodeBase::BasePtr;
+  using ColorType = PersistentNodeBase::ColorType;
+  using Node = PersistentNode<value_type>;
+  using NodePtr = Node*;
+  using NodeAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+  static constexpr int kMaxDepth = PersistentNodeBase::kMaxDepth;
+
+  // The nodes a search passed and the side of each it left through.
+  struct Path {
+    BasePtr node[kMaxDepth];
+    int dir[kMaxDepth];
+    int depth = 0;
+  };
+
+  static const value_type& Data(const PersistentNodeBase* node) noexcept {
+    return static_cast<const Node*>(node)->m_data;
+  }
+
+  static bool IsRed(BasePtr node) noexcept {
+    return node && node->color == ColorType::kRed;
+  }
+
+  static BasePtr Share(BasePtr node) noexcept {
+    if (node) {
+      node->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    return node;
+  }
+
+  template <typename... Args>
+  NodePtr CreateNode(Args&&... args) {
+    NodePtr node = NodeTraits::allocate(allocator_, 1);
+    try {
+      NodeTraits::construct(allocator_, std::addressof(node->m_data),
+                            std::forward<Args>(args)...);
+    } catch (...) {
+      NodeTraits::deallocate(allocator_, node, 1);
+      throw;
+    }
+    node->refs.store(1, std::memory_order_relaxed);
+    node->link[0] = node->link[1] = nullptr;
+    node->color = ColorType::kRed;
+    return node;
+  }
+
+  void DestroyNode(BasePtr node) noexcept {
+    NodePtr full = static_cast<NodePtr>(node);
+    NodeTraits::destroy(allocator_, std::addressof(full->m_data));
+    NodeTraits::deallocate(allocator_, full, 1);
+  }
+
+  // Drops one reference to root and frees every node that it was the last
+  // holder of.
+  void Release(BasePtr root) noexcept {
+    BasePtr pending[kMaxDepth];
+    int depth = 0;
+    while (root) {
+      BasePtr next = nullptr;
+      if (root->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (root->link[1]) {
+          pending[depth++] = root->link[1];
+        }
+        next = root->link[0];
+        DestroyNode(root);
+      }
+      root = next ? next : depth ? pending[--depth] : nullptr;
+    }
+  }
+
+  // Makes the node in slot one that this map alone holds, copying it when
+  // another version shares it; the copy shares the children instead.
+  BasePtr Own(BasePtr& slot) {
+    BasePtr node = slot;
+    if (node->refs.load(std::memory_order_acquire) != 1) {
+      NodePtr copy = CreateNode(Data(node));
+      copy->color = node->color;
+      copy->link[0] = Share(node->link[0]);
+      copy->link[1] = Share(node->link[1]);
+      Release(node);
+      slot = copy;
+    }
+    return slot;
+  }
+
+  BasePtr FindNode(const Key& key) const {
+    BasePtr node = root_;
+    while (node) {
+      if (compare_(key, Data(node).first)) {
+        node = node->link[0];
+      } else if (compare_(Data(node).first, key)) {
+        node = node->link[1];
+      } else {
+        break;
+      }
+    }
+    return node;
+  }
+
+  // Returns the node holding key, or null with path ending at the empty
+  // link where it belongs. The node itself is not on the path.
+  BasePtr Search(const Key& key, Path& path) const {
+    BasePtr node = root_;
+    while (node) {
+      int dir;
+      if (compare_(key, Data(node).first)) {
+        dir = 0;
+      } else if (compare_(Data(node).first, key)) {
+        dir = 1;
+      } else {
+        break;
+      }
+      path.node[path.depth] = node;
+      path.dir[path.depth++] = dir;
+      node = node->link[dir];
+    }
+    return node;
+  }
+
+  // Owns every node on path, top down, and returns the link below them.
+  // Each step only swaps a node for an equal copy, so a copy that throws
+  // leaves the map as it was.
+  BasePtr* OwnPath(Path& path) {
+    BasePtr* slot = &root_;
+    for (int i = 0; i < path.depth; ++i) {
+      path.node[i] = Own(*slot);
+      slot = &path.node[i]->link[path.dir[i]];
+    }
+    return slot;
+  }
+
+  template <typename... Args>
+  void InsertAt(Path& path, Args&&... args) {
+    BasePtr* slot = OwnPath(path);
+    *slot = CreateNode(std::forward<Args>(args)...);
+    ++size_;
+    FixInsert(path);
+  }
+
+  template <typename... Args>
+  bool Insert(const Key& key, Args&&... args) {
+    Path path;
+    if (Search(key, path)) {
+      return false;
+    }
+    InsertAt(path, std::forward<Args>(args)...);
+    return true;
+  }
+
+  template <typename K, typename M>
+  bool InsertOrAssign(K&& key, M&& obj) {
+    Path path;
+    if (Search(key, path)) {
+      BasePtr* slot = OwnPath(path);
+      static_cast<NodePtr>(Own(*slot))->m_data.second = std::forward<M>(obj);
+      return false;
+    }
+    InsertAt(path, std::forward<K>(key), std::forward<M>(obj));
+    return true;
+  }
+
+  // Okasaki's balance, bottom up: a red node on the path with a red child
+  // is rotated under its black parent into a red node with two black
+  // children, which may clash again two levels up. Only path nodes move,
+  // so nothing off the path has to be copied.
+  void FixInsert(const Path& path) noexcept {
+    for (int i = path.depth - 1; i > 0 && IsRed(path.node[i]); i -= 2) {
+      BasePtr top = Balance(path.node[i - 1], path.dir[i - 1], path.dir[i]);
+      (i > 1 ? path.node[i - 2]->link[path.dir[i - 2]] : root_) = top;
+    }
+    root_->color = ColorType::kBlack;
+  }
+
+  // grand's child on side dir and that child's child on side next are red.
+  static BasePtr Balance(BasePtr grand, int dir, int next) noexcept {
+    BasePtr parent = grand->link[dir];
+    BasePtr child = parent->link[next];
+    BasePtr top;
+    if (dir == next) {
+      grand->link[dir] = parent->link[!dir];
+      parent->link[!dir] = grand;
+      top = parent;
+      child->color = ColorType::kBlack;
+    } else {
+      parent->link[next] = child->link[dir];
+      grand->link[dir] = child->link[next];
+      child->link[dir] = parent;
+      child->link[next] = grand;
+      top = child;
+      parent->color = ColorType::kBlack;
+    }
+    grand->color = ColorType::kBlack;
+    top->color = ColorType::kRed;
+    return top;
+  }
+
+  // Lifts root's child on side !dir above it; root turns red, the child
+  // black.
+  static BasePtr Rotate(BasePtr root, int dir) noexcept {
+    BasePtr save = root->link[!dir];
+    root->link[!dir] = save->link[dir];
+    save->link[dir] = root;
+    root->color = ColorType::kRed;
+    save->color = ColorType::kBlack;
+    return save;
+  }
+
+  static BasePtr RotateTwice(BasePtr root, int dir) noexcept {
+    root->link[!dir] = Rotate(root->link[!dir], !dir);
+    return Rotate(root, dir);
+  }
+
+  // A red root is always owned: it was recolored or rotated into place.
+  void SetRoot(BasePtr root) noexcept {
+    root_ = root;
+    if (IsRed(root_)) {
+      root_->color = ColorType::kBlack;
+    }
+  }
+
+  // Top-down deletion after Julienne Walker. The walk keeps the node it steps
+  // into red with color flips and rotations, each of which turns a valid tree
+  // (but for a red root) into another holding the same keys. The nodes a step
+  // touches are owned before it changes anything, so a copy that throws
+  // leaves a valid map. The walk ends on the in-order predecessor of key's
+  // node, or on that node itself, with at most one child, and unlinks it;
+  // a predecessor then takes the place of key's node.
+  void EraseTopDown(BasePtr head, const Key& key) {
+    BasePtr grand = nullptr, parent = nullptr, node = head, found = nullptr;
+    int dir = 1;
+    while (node->link[dir]) {
+      int last = dir;
+      grand = parent;
+      parent = node;
+      node = Own(parent->link[dir]);
+      dir = compare_(Data(node).first, key);
+      if (!dir && !compare_(key, Data(node).first)) {
+        found = node;
+      }
+      if (IsRed(node) || IsRed(node->link[dir])) {
+        continue;
+      }
+      if (IsRed(node->link[!dir])) {
+        Own(node->link[!dir]);
+        parent = parent->link[last] = Rotate(node, dir);
+      } else if (BasePtr sibling = parent->link[!last]) {
+        if (!IsRed(sibling->link[0]) && !IsRed(sibling->link[1])) {
+          Own(parent->link[!last])->color = ColorType::kRed;
+          parent->color = ColorType::kBlack;
+          node->color = ColorType::kRed;
+        } else {
+          int side = grand->link[1] == parent;
+          sibling = Own(parent->link[!last]);
+          if (IsRed(sibling->link[last])) {
+            Own(sibling->link[last]);
+            grand->link[side] = RotateTwice(parent, last);
+          } else {
+            Own(sibling->link[!last]);
+            grand->link[side] = Rotate(parent, last);
+          }
+          BasePtr top = grand->link[side];
+          node->color = top->color = ColorType::kRed;
+          top->link[0]->color = top->link[1]->color = ColorType::kBlack;
+        }
+      }
+    }
+    parent->link[parent->link[1] == node] = node->link[!node->link[0]];
+    if (node != found) {
+      // Every ancestor of found was owned on the way down or by a rotation.
+      BasePtr above = head;
+      int side = 1;
+      while (above->link[side] != found) {
+        above = above->link[side];
+        side = compare_(Data(above).first, key);
+      }
+      above->link[side] = node;
+      node->link[0] = found->link[0];
+      node->link[1] = found->link[1];
+      node->color = found->color;
+    }
+    DestroyNode(found);
+  }
+
+  BasePtr root_{};
+  size_type size_{};
+  Compare compare_{};
+  NodeAlloc allocator_{};
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINER_SRC_S21_PERSISTENT_MAP_H_
@@ -9,28 +9,53 @@
 
 namespace s21 {
 
-template <typename Key, typename Compare = std::less<Key>>
+template <typename Key, typename Compare = std::less<Key>,
+          typename Alloc = std::allocator<Key>, bool OrderStatistic = false,
+          typename Augment = Augments::None>
 class set {
+  template <typename InputIt>
+  using RequireInputIter = std::enable_if_t<std::is_convertible<
+      typename std::iterator_traits<InputIt>::iterator_category,
+      std::input_iterator_tag>::value>;
+
  public:
   using key_type = Key;
   using value_type = Key;
   using reference = Key&;
   using const_reference = const Key&;
-  using tree =
-      RBTree<key_type, value_type, KeyGetters::Identity<value_type>, Compare>;
+  using tree = RBTree<key_type, value_type, KeyGetters::Identity<value_type>,
+                      Compare, Alloc, OrderStatistic, Augment>;
   using iterator = typename tree::iterator;
   using const_iterator = typename tree::const_iterator;
+  using reverse_iterator = typename tree::reverse_iterator;
+  using const_reverse_iterator = typename tree::const_reverse_iterator;
   using size_type = typename tree::size_type;
+  using difference_type = typename tree::difference_type;
+  using allocator_type = Alloc;
+  using node_type = typename tree::node_type;
+  using insert_return_type = typename tree::insert_return_type;
 
   set() = default;
 
   set(std::initializer_list<value_type> const& items) {
-    for (auto& item : items) {
-      tree_.insert_unique(item);
-    }
+    tree_.assign_unique(items.begin(), items.end());
+  }
+
+  template <typename InputIt, typename = RequireInputIter<InputIt>>
+  set(InputIt first, InputIt last) {
+    tree_.assign_unique(first, last);
+  }
+
+  template <typename InputIt>
+  set(sorted_unique_t, InputIt first, InputIt last) {
+    tree_.assign_unique(first, last);
   }
 
-  set(const set& other) noexcept : tree_(other.tree_) {}
+  // The result of lhs op rhs; see set_union() and friends below.
+  set(SetOperation op, const set& lhs, const set& rhs)
+      : tree_(op, lhs.tree_, rhs.tree_) {}
+
+  set(const set& other) : tree_(other.tree_) {}
 
   set(set&& other) noexcept : tree_(std::move(other.tree_)) {}
 
@@ -54,30 +79,145 @@ class set {
 
   size_type max_size() const noexcept { return tree_.max_size(); }
 
+  // Smallest and largest elements in O(1); not for an empty set.
+  const_reference min() const noexcept { return tree_.min(); }
+
+  const_reference max() const noexcept { return tree_.max(); }
+
+  void pop_front() noexcept { tree_.pop_front(); }
+
+  void pop_back() noexcept { tree_.pop_back(); }
+
   std::pair<iterator, bool> insert(const value_type& value) {
     return tree_.insert_unique(value);
   }
 
+  iterator insert(const_iterator hint, const value_type& value) {
+    return tree_.insert_unique(hint, value);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return tree_.insert_unique(std::move(value));
+  }
+
+  iterator insert(const_iterator hint, value_type&& value) {
+    return tree_.insert_unique(hint, std::move(value));
+  }
+
+  insert_return_type insert(node_type&& handle) {
+    return tree_.insert_unique(std::move(handle));
+  }
+
+  node_type extract(const_iterator pos) noexcept { return tree_.extract(pos); }
+
+  node_type extract(const Key& key) noexcept { return tree_.extract(key); }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return tree_.emplace_unique(std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return tree_.emplace_hint_unique(hint, std::forward<Args>(args)...);
+  }
+
   template <typename... Args>
   vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
     vector<std::pair<iterator, bool>> inserted;
     std::pair<iterator, bool> ins_pair;
-    ((ins_pair = insert(args), inserted.push_back(ins_pair)), ...);
+    ((ins_pair = insert(std::forward<Args>(args)),
+      inserted.push_back(ins_pair)),
+     ...);
     return inserted;
   }
 
-  void erase(iterator pos) { tree_.erase(*pos); }
+  iterator erase(iterator pos) { return tree_.erase(pos); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    return tree_.erase(first, last);
+  }
+
+  size_type erase(const Key& key) { return tree_.erase(key); }
+
+  // Erases the elements pred holds for in one pass over the set.
+  template <typename Pred>
+  size_type erase_if(Pred pred) {
+    return tree_.erase_if(pred);
+  }
 
   void swap(set& other) noexcept { tree_.swap(other.tree_); }
 
   void merge(set& other) { tree_.merge_unique(other.tree_); }
 
+  // Moves the elements with keys not less than key into the returned set;
+  // see RBTree::split() for the cost.
+  set split(const key_type& key) {
+    set upper;
+    upper.tree_ = tree_.split(key);
+    return upper;
+  }
+
+  // Appends other, whose keys must all sort after ours, in O(log n). Throws
+  // std::invalid_argument when they do not.
+  void join(set& other) { tree_.join_unique(other.tree_); }
+
   iterator find(const Key& key) noexcept { return tree_.find(key); }
 
   const_iterator find(const Key& key) const noexcept { return tree_.find(key); }
 
-  bool contains(const Key& key) const noexcept {
-    return tree_.find(key) != end();
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  iterator find(const K& key) noexcept {
+    return tree_.find(key);
+  }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  const_iterator find(const K& key) const noexcept {
+    return tree_.find(key);
+  }
+
+  bool contains(const Key& key) const noexcept { return tree_.contains(key); }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  bool contains(const K& key) const noexcept {
+    return tree_.contains(key);
+  }
+
+  size_type rank(const Key& key) const noexcept { return tree_.rank(key); }
+
+  iterator select(size_type pos) noexcept { return tree_.select(pos); }
+
+  const_iterator select(size_type pos) const noexcept {
+    return tree_.select(pos);
+  }
+
+  difference_type distance(const_iterator first,
+                           const_iterator last) const noexcept {
+    return tree_.distance(first, last);
+  }
+
+  template <typename Aug = Augment>
+  typename Aug::value_type aggregate(const Key& lower,
+                                     const Key& upper) const noexcept {
+    return tree_.aggregate(lower, upper);
+  }
+
+  // In-place set operations; nodes of this set are reused.
+  void union_with(const set& other) {
+    tree_.apply_set_operation(SetOperation::kUnion, other.tree_);
+  }
+
+  void intersect_with(const set& other) {
+    tree_.apply_set_operation(SetOperation::kIntersection, other.tree_);
+  }
+
+  void difference_with(const set& other) {
+    tree_.apply_set_operation(SetOperation::kDifference, other.tree_);
+  }
+
+  void symmetric_difference_with(const set& other) {
+    tree_.apply_set_operation(SetOperation::kSymmetricDifference,
+                              other.tree_);
   }
 
   iterator begin() noexcept { return tree_.begin(); }
@@ -92,10 +232,55 @@ class set {
 
   const_iterator cend() const noexcept { return tree_.cend(); }
 
+  reverse_iterator rbegin() noexcept { return tree_.rbegin(); }
+
+  const_reverse_iterator rbegin() const noexcept { return tree_.rbegin(); }
+
+  const_reverse_iterator crbegin() const noexcept { return tree_.rbegin(); }
+
+  reverse_iterator rend() noexcept { return tree_.rend(); }
+
+  const_reverse_iterator rend() const noexcept { return tree_.rend(); }
+
+  const_reverse_iterator crend() const noexcept { return tree_.rend(); }
+
  private:
   tree tree_{};
 };
 
+// O(n + m) set operations.
+
+template <typename K, typename C, typename A, bool S, typename G>
+set<K, C, A, S, G> set_union(const set<K, C, A, S, G>& lhs,
+                             const set<K, C, A, S, G>& rhs) {
+  return set<K, C, A, S, G>(SetOperation::kUnion, lhs, rhs);
+}
+
+template <typename K, typename C, typename A, bool S, typename G>
+set<K, C, A, S, G> set_intersection(const set<K, C, A, S, G>& lhs,
+                                    const set<K, C, A, S, G>& rhs) {
+  return set<K, C, A, S, G>(SetOperation::kIntersection, lhs, rhs);
+}
+
+template <typename K, typename C, typename A, bool S, typename G>
+set<K, C, A, S, G> set_difference(const set<K, C, A, S, G>& lhs,
+                                  const set<K, C, A, S, G>& rhs) {
+  return set<K, C, A, S, G>(SetOperation::kDifference, lhs, rhs);
+}
+
+template <typename K, typename C, typename A, bool S, typename G>
+set<K, C, A, S, G> set_symmetric_difference(const set<K, C, A, S, G>& lhs,
+                                            const set<K, C, A, S, G>& rhs) {
+  return set<K, C, A, S, G>(SetOperation::kSymmetricDifference, lhs, rhs);
+}
+
+// Pass rvalues to join in O(log n); lvalue arguments are copied first.
+template <typename K, typename C, typename A, bool S, typename G>
+set<K, C, A, S, G> join(set<K, C, A, S, G> lhs, set<K, C, A, S, G> rhs) {
+  lhs.join(rhs);
+  return lhs;
+}
+
 }  // namespace s21
 
 #endif  // S21_CONTAINER_SRC_S21_SET_H_
\ No newline at end of file
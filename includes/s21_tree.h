@@ -1,35 +1,62 @@
 #ifndef S21_CONTAINER_SRC_S21_TREE_H_
 #define S21_CONTAINER_SRC_S21_TREE_H_
 
+#include <cstdint>
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 namespace s21 {
 
 enum class RBTreeNodeColor : bool { kRed, kBlack };
 
+// The color lives in the low bit of the parent pointer, which is always
+// zero because nodes are at least pointer aligned.
 struct RBTreeNodeBase {
   using ColorType = RBTreeNodeColor;
   using BasePtr = RBTreeNodeBase*;
 
-  RBTreeNodeBase() = default;
-  explicit RBTreeNodeBase(ColorType o_color) noexcept : color(o_color) {}
+  static constexpr uintptr_t kColorMask = 1;
 
-  ColorType color{};
-  BasePtr parent{};
+  BasePtr parent() const noexcept {
+    return reinterpret_cast<BasePtr>(parent_and_color & ~kColorMask);
+  }
+
+  void set_parent(BasePtr o_parent) noexcept {
+    parent_and_color = reinterpret_cast<uintptr_t>(o_parent) |
+                       (parent_and_color & kColorMask);
+  }
+
+  ColorType color() const noexcept {
+    return static_cast<ColorType>(parent_and_color & kColorMask);
+  }
+
+  void set_color(ColorType o_color) noexcept {
+    parent_and_color = (parent_and_color & ~kColorMask) |
+                       static_cast<uintptr_t>(o_color);
+  }
+
+  uintptr_t parent_and_color{};
   BasePtr left{};
   BasePtr right{};
 };
 
+static_assert(alignof(RBTreeNodeBase) > RBTreeNodeBase::kColorMask,
+              "The color bit must not overlap the parent address");
+
 template <typename Tp>
 struct RBTreeNode : public RBTreeNodeBase {
   Tp m_data;
+};
 
-  RBTreeNode() = default;
-  RBTreeNode(const RBTreeNode& other)
-      : RBTreeNodeBase(other.color), m_data(other.m_data) {}
-  explicit RBTreeNode(const Tp& value) : m_data(value) {}
+// Node of an order-statistic tree: also knows the size of its subtree.
+template <typename Tp>
+struct RBTreeCountedNode : public RBTreeNode<Tp> {
+  size_t subtree_size;
 };
 
 struct RBTreeIteratorBase {
@@ -49,10 +76,10 @@ struct RBTreeIteratorBase {
         node = node->left;
       }
     } else {
-      BasePtr tmp = node->parent;
+      BasePtr tmp = node->parent();
       while (node == tmp->right) {
         node = tmp;
-        tmp = tmp->parent;
+        tmp = tmp->parent();
       }
       if (node->right != tmp) {
         node = tmp;
@@ -61,7 +88,7 @@ struct RBTreeIteratorBase {
   }
 
   void Decrement() noexcept {
-    if (node->color == ColorType::kRed && node->parent->parent == node) {
+    if (node->color() == ColorType::kRed && node->parent()->parent() == node) {
       node = node->right;
     } else if (node->left) {
       BasePtr tmp = node->left;
@@ -70,10 +97,10 @@ struct RBTreeIteratorBase {
       }
       node = tmp;
     } else {
-      BasePtr tmp = node->parent;
+      BasePtr tmp = node->parent();
       while (node == tmp->left) {
         node = tmp;
-        tmp = tmp->parent;
+        tmp = tmp->parent();
       }
       node = tmp;
     }
@@ -91,6 +118,11 @@ struct RBTreeIterator : public RBTreeIteratorBase {
   explicit RBTreeIterator(BasePtr ptr = nullptr) noexcept
       : RBTreeIteratorBase(ptr) {}
 
+  // iterator -> const_iterator; a template so it never becomes the copy ctor.
+  template <typename Iter, typename = std::enable_if_t<std::is_same_v<
+                               Iter, RBTreeIterator<Val, Val&, Val*>>>>
+  RBTreeIterator(const Iter& it) noexcept : RBTreeIteratorBase(it.node) {}
+
   reference operator*() const noexcept {
     return static_cast<NodePtr>(node)->m_data;
   }
@@ -132,6 +164,40 @@ inline bool operator!=(const RBTreeIteratorBase& rhs,
   return rhs.node != lhs.node;
 }
 
+// Tags for constructors that take a range already sorted by the comparator,
+// without duplicates or with them.
+struct sorted_unique_t {
+  explicit sorted_unique_t() = default;
+};
+inline constexpr sorted_unique_t sorted_unique{};
+
+struct sorted_equivalent_t {
+  explicit sorted_equivalent_t() = default;
+};
+inline constexpr sorted_equivalent_t sorted_equivalent{};
+
+// What a set operation keeps, with multiset counts treated as std's
+// set_union & co. treat them: max, min, difference and |difference|.
+enum class SetOperation {
+  kUnion,
+  kIntersection,
+  kDifference,
+  kSymmetricDifference
+};
+
+// Lookups take any key type K when the comparator declares is_transparent,
+// so e.g. a std::string keyed tree can be searched with a std::string_view.
+template <typename Compare, typename = void>
+struct IsTransparent : std::false_type {};
+
+template <typename Compare>
+struct IsTransparent<Compare, std::void_t<typename Compare::is_transparent>>
+    : std::true_type {};
+
+template <typename Compare, typename K>
+using RequireTransparent =
+    std::enable_if_t<IsTransparent<Compare>::value, const K&>;
+
 namespace KeyGetters {
 
 template <class Tp>
@@ -146,9 +212,175 @@ struct SelectFirst {
   }
 };
 
+template <class Pair>
+struct SelectSecond {
+  const typename Pair::second_type& operator()(const Pair& p) const noexcept {
+    return p.second;
+  }
+};
+
 }  // namespace KeyGetters
 
-template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+// Augmentation policies: every node keeps combine() of lift() over its
+// subtree, in key order. combine() must be associative with identity() as
+// its neutral element, and none of them may throw.
+namespace Augments {
+
+struct None {};
+
+template <class Value, class Getter = KeyGetters::Identity<Value>>
+struct Sum {
+  using value_type =
+      std::decay_t<decltype(Getter()(std::declval<const Value&>()))>;
+
+  static value_type identity() noexcept { return value_type(); }
+  static value_type lift(const Value& v) noexcept { return Getter()(v); }
+  static value_type combine(const value_type& lhs,
+                            const value_type& rhs) noexcept {
+    return lhs + rhs;
+  }
+};
+
+template <class Value, class Getter = KeyGetters::Identity<Value>>
+struct Max {
+  using value_type =
+      std::decay_t<decltype(Getter()(std::declval<const Value&>()))>;
+
+  static value_type identity() noexcept {
+    return std::numeric_limits<value_type>::lowest();
+  }
+  static value_type lift(const Value& v) noexcept { return Getter()(v); }
+  static value_type combine(const value_type& lhs,
+                            const value_type& rhs) noexcept {
+    return lhs < rhs ? rhs : lhs;
+  }
+};
+
+template <class Value, class Getter = KeyGetters::Identity<Value>>
+struct Min {
+  using value_type =
+      std::decay_t<decltype(Getter()(std::declval<const Value&>()))>;
+
+  static value_type identity() noexcept {
+    return std::numeric_limits<value_type>::max();
+  }
+  static value_type lift(const Value& v) noexcept { return Getter()(v); }
+  static value_type combine(const value_type& lhs,
+                            const value_type& rhs) noexcept {
+    return rhs < lhs ? rhs : lhs;
+  }
+};
+
+}  // namespace Augments
+
+template <typename Base, typename Aggregate>
+struct RBTreeAugmentedNode : public Base {
+  Aggregate aggregate;
+};
+
+template <typename Tp, bool OrderStatistic, typename Augment>
+struct RBTreeNodeFor {
+  using type = RBTreeAugmentedNode<
+      typename RBTreeNodeFor<Tp, OrderStatistic, Augments::None>::type,
+      typename Augment::value_type>;
+};
+
+template <typename Tp, bool OrderStatistic>
+struct RBTreeNodeFor<Tp, OrderStatistic, Augments::None> {
+  using type = std::conditional_t<OrderStatistic, RBTreeCountedNode<Tp>,
+                                  RBTreeNode<Tp>>;
+};
+
+// Owns a node taken out of a tree by extract() until it is inserted into
+// another one (or dropped). The value never moves in between.
+template <typename Value, typename Node, typename NodeAlloc>
+class RBTreeNodeHandle {
+ public:
+  using value_type = Value;
+  using allocator_type = NodeAlloc;
+
+  RBTreeNodeHandle() noexcept = default;
+
+  RBTreeNodeHandle(RBTreeNodeHandle&& other) noexcept
+      : node_(other.node_), allocator_(std::move(other.allocator_)) {
+    other.node_ = nullptr;
+  }
+
+  RBTreeNodeHandle& operator=(RBTreeNodeHandle&& other) noexcept {
+    if (this != &other) {
+      reset();
+      node_ = other.node_;
+      allocator_ = std::move(other.allocator_);
+      other.node_ = nullptr;
+    }
+    return *this;
+  }
+
+  RBTreeNodeHandle(const RBTreeNodeHandle&) = delete;
+  RBTreeNodeHandle& operator=(const RBTreeNodeHandle&) = delete;
+
+  ~RBTreeNodeHandle() { reset(); }
+
+  bool empty() const noexcept { return node_ == nullptr; }
+
+  explicit operator bool() const noexcept { return node_ != nullptr; }
+
+  allocator_type get_allocator() const { return allocator_; }
+
+  value_type& value() const noexcept { return node_->m_data; }
+
+  template <typename V = Value>
+  typename V::first_type& key() const noexcept {
+    return node_->m_data.first;
+  }
+
+  template <typename V = Value>
+  typename V::second_type& mapped() const noexcept {
+    return node_->m_data.second;
+  }
+
+  void swap(RBTreeNodeHandle& other) noexcept {
+    std::swap(node_, other.node_);
+    std::swap(allocator_, other.allocator_);
+  }
+
+ private:
+  template <typename, typename, typename, typename, typename, bool, typename>
+  friend class RBTree;
+
+  using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+  RBTreeNodeHandle(Node* node, const NodeAlloc& allocator) noexcept
+      : node_(node), allocator_(allocator) {}
+
+  Node* release() noexcept {
+    Node* node = node_;
+    node_ = nullptr;
+    return node;
+  }
+
+  void reset() noexcept {
+    if (node_) {
+      NodeTraits::destroy(allocator_, std::addressof(node_->m_data));
+      NodeTraits::deallocate(allocator_, node_, 1);
+      node_ = nullptr;
+    }
+  }
+
+  Node* node_{};
+  NodeAlloc allocator_{};
+};
+
+template <typename Iterator, typename NodeType>
+struct RBTreeInsertReturn {
+  Iterator position;
+  bool inserted;
+  NodeType node;
+};
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare,
+          typename Alloc = std::allocator<Value>, bool OrderStatistic = false,
+          typename Augment = Augments::None>
 class RBTree {
  public:
   using key_type = Key;
@@ -157,7 +389,7 @@ class RBTree {
   using const_pointer = const Value*;
   using reference = Value&;
   using const_reference = const Value&;
-  using Node = RBTreeNode<Value>;
+  using Node = typename RBTreeNodeFor<Value, OrderStatistic, Augment>::type;
   using NodePtr = Node*;
   using BasePtr = typename RBTreeNodeBase::BasePtr;
   using ColorType = typename RBTreeNodeBase::ColorType;
@@ -166,40 +398,91 @@ class RBTree {
   using iterator = RBTreeIterator<value_type, reference, pointer>;
   using const_iterator =
       RBTreeIterator<value_type, const_reference, const_pointer>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using allocator_type = Alloc;
+  using node_type = RBTreeNodeHandle<
+      Value, Node,
+      typename std::allocator_traits<Alloc>::template rebind_alloc<Node>>;
+  using insert_return_type = RBTreeInsertReturn<iterator, node_type>;
 
-  RBTree() : base_(new Node()) {
-    base_->parent = nullptr;
-    base_->left = base_->right = base_;
-  }
+  RBTree() { ResetHeader(); }
 
   RBTree(const RBTree& other)
-      : node_count_(other.node_count_),
-        compare_(other.compare_),
-        base_(new Node()) {
-    base_->color = ColorType::kRed;
-    if (!other.base_->parent) {
-      base_->parent = nullptr;
-      base_->left = base_->right = base_;
-    } else {
-      base_->parent = CopyTree(other.base_->parent, base_);
-      base_->left = GetMinNode(base_->parent);
-      base_->right = GetMaxNode(base_->parent);
+      : compare_(other.compare_),
+        allocator_(NodeTraits::select_on_container_copy_construction(
+            other.allocator_)) {
+    ResetHeader();
+    if (other.header_.parent()) {
+      header_.set_parent(
+          CopyTree(other.header_.parent(), Header(), other.node_count_));
+      header_.left = GetMinNode(header_.parent());
+      header_.right = GetMaxNode(header_.parent());
+      node_count_ = other.node_count_;
     }
   }
 
-  RBTree(RBTree&& other) noexcept
-      : node_count_(other.node_count_),
-        compare_(other.compare_),
-        base_(other.base_) {
-    other.base_ = nullptr;
-    other.node_count_ = 0;
+  // Builds lhs op rhs from copies of their values in O(n + m): one in-order
+  // merge of both trees into a chain, then a balanced bottom-up build.
+  RBTree(SetOperation op, const RBTree& lhs, const RBTree& rhs)
+      : compare_(lhs.compare_),
+        allocator_(NodeTraits::select_on_container_copy_construction(
+            lhs.allocator_)) {
+    ResetHeader();
+    RBTreeNodeBase chain;
+    BasePtr tail = &chain;
+    size_type count = 0;
+    auto emit = [&](BasePtr node) {
+      tail->right = CreateNode(static_cast<NodePtr>(node)->m_data);
+      tail = tail->right;
+      ++count;
+    };
+    BasePtr lhs_node = lhs.header_.left, rhs_node = rhs.header_.left;
+    try {
+      while (lhs_node != lhs.Header() && rhs_node != rhs.Header()) {
+        if (compare_(GetKey(lhs_node), GetKey(rhs_node))) {
+          if (KeepsLhsOnly(op)) {
+            emit(lhs_node);
+          }
+          lhs_node = NextNode(lhs_node);
+        } else if (compare_(GetKey(rhs_node), GetKey(lhs_node))) {
+          if (KeepsRhsOnly(op)) {
+            emit(rhs_node);
+          }
+          rhs_node = NextNode(rhs_node);
+        } else {
+          if (KeepsCommon(op)) {
+            emit(lhs_node);
+          }
+          lhs_node = NextNode(lhs_node);
+          rhs_node = NextNode(rhs_node);
+        }
+      }
+      for (; lhs_node != lhs.Header() && KeepsLhsOnly(op);
+           lhs_node = NextNode(lhs_node)) {
+        emit(lhs_node);
+      }
+      for (; rhs_node != rhs.Header() && KeepsRhsOnly(op);
+           rhs_node = NextNode(rhs_node)) {
+        emit(rhs_node);
+      }
+    } catch (...) {
+      tail->right = nullptr;
+      DestroyChain(chain.right);
+      throw;
+    }
+    tail->right = nullptr;
+    LinkChain(chain.right, count);
   }
 
-  ~RBTree() {
-    clear();
-    delete base_;
+  RBTree(RBTree&& other) noexcept
+      : compare_(other.compare_), allocator_(std::move(other.allocator_)) {
+    ResetHeader();
+    SwapHeaders(other);
   }
 
+  ~RBTree() { clear(); }
+
   RBTree& operator=(const RBTree& other) {
     if (this != &other) {
       RBTree tmp(other);
@@ -216,32 +499,158 @@ class RBTree {
     return *this;
   }
 
-  void clear() {
+  void clear() noexcept {
     if (node_count_ != 0) {
-      DeleteTree(base_->parent);
-      base_->parent = nullptr;
-      base_->left = base_->right = base_;
-      node_count_ = 0;
+      if constexpr (kPooled) {
+        if (allocator_.in_use() == node_count_) {
+          if constexpr (!std::is_trivially_destructible<Value>::value) {
+            DestroyValues(header_.parent());
+          }
+          allocator_.release();
+          ResetHeader();
+          return;
+        }
+      }
+      DeleteTree(header_.parent());
+      ResetHeader();
+    }
+  }
+
+  // Replaces the contents with a range in O(n) when it is sorted by Compare:
+  // the nodes are linked into a balanced tree directly, with no search and
+  // no rotation. A range out of order is merge sorted as a node chain first.
+  // The sort is stable, and assign_unique() keeps the first of equal
+  // elements, as repeated insert_unique() would.
+  template <typename InputIt>
+  void assign_unique(InputIt first, InputIt last) {
+    AssignRange(first, last, true);
+  }
+
+  template <typename InputIt>
+  void assign_equal(InputIt first, InputIt last) {
+    AssignRange(first, last, false);
+  }
+
+  // this = this op other in O(n + m). Our own nodes are kept or destroyed,
+  // only elements that come from other are copied.
+  void apply_set_operation(SetOperation op, const RBTree& other) {
+    if (this == &other) {
+      if (op == SetOperation::kDifference ||
+          op == SetOperation::kSymmetricDifference) {
+        clear();
+      }
+      return;
+    }
+    RBTreeNodeBase own, chain;
+    BasePtr tail = &own;
+    FlattenTree(header_.parent(), tail);
+    tail->right = nullptr;
+    tail = &chain;
+    size_type count = 0;
+    auto keep = [&](BasePtr node) {
+      tail->right = node;
+      tail = node;
+      ++count;
+    };
+    BasePtr lhs_node = own.right, rhs_node = other.header_.left;
+    try {
+      while (lhs_node && rhs_node != other.Header()) {
+        BasePtr next = lhs_node->right;
+        if (compare_(GetKey(lhs_node), GetKey(rhs_node))) {
+          if (KeepsLhsOnly(op)) {
+            keep(lhs_node);
+          } else {
+            DestroyNode(static_cast<NodePtr>(lhs_node));
+          }
+          lhs_node = next;
+        } else if (compare_(GetKey(rhs_node), GetKey(lhs_node))) {
+          if (KeepsRhsOnly(op)) {
+            keep(CreateNode(static_cast<NodePtr>(rhs_node)->m_data));
+          }
+          rhs_node = other.NextNode(rhs_node);
+        } else {
+          if (KeepsCommon(op)) {
+            keep(lhs_node);
+          } else {
+            DestroyNode(static_cast<NodePtr>(lhs_node));
+          }
+          lhs_node = next;
+          rhs_node = other.NextNode(rhs_node);
+        }
+      }
+      while (lhs_node) {
+        BasePtr next = lhs_node->right;
+        if (KeepsLhsOnly(op)) {
+          keep(lhs_node);
+        } else {
+          DestroyNode(static_cast<NodePtr>(lhs_node));
+        }
+        lhs_node = next;
+      }
+      for (; rhs_node != other.Header() && KeepsRhsOnly(op);
+           rhs_node = other.NextNode(rhs_node)) {
+        keep(CreateNode(static_cast<NodePtr>(rhs_node)->m_data));
+      }
+    } catch (...) {
+      // Everything left of ours sorts after what is in the chain already.
+      tail->right = lhs_node;
+      for (; lhs_node; lhs_node = lhs_node->right) {
+        ++count;
+      }
+      LinkChain(chain.right, count);
+      throw;
     }
+    tail->right = nullptr;
+    LinkChain(chain.right, count);
   }
 
   void swap(RBTree& other) noexcept {
-    std::swap(other.base_, base_);
-    std::swap(other.node_count_, node_count_);
+    SwapHeaders(other);
     std::swap(other.compare_, compare_);
+    std::swap(other.allocator_, allocator_);
+  }
+
+  iterator begin() noexcept { return iterator(header_.left); }
+
+  const_iterator begin() const noexcept { return const_iterator(header_.left); }
+
+  const_iterator cbegin() const noexcept {
+    return const_iterator(header_.left);
   }
 
-  iterator begin() noexcept { return iterator(base_->left); }
+  iterator end() noexcept { return iterator(Header()); }
 
-  const_iterator begin() const noexcept { return const_iterator(base_->left); }
+  const_iterator end() const noexcept { return const_iterator(Header()); }
 
-  const_iterator cbegin() const noexcept { return const_iterator(base_->left); }
+  const_iterator cend() const noexcept { return const_iterator(Header()); }
 
-  iterator end() noexcept { return iterator(base_); }
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
 
-  const_iterator end() const noexcept { return const_iterator(base_); }
+  const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
 
-  const_iterator cend() const noexcept { return const_iterator(base_); }
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+
+  // The header keeps the leftmost and rightmost nodes, so both ends are
+  // O(1). Neither may be called on an empty tree.
+  const_reference min() const noexcept {
+    return static_cast<NodePtr>(header_.left)->m_data;
+  }
+
+  const_reference max() const noexcept {
+    return static_cast<NodePtr>(header_.right)->m_data;
+  }
+
+  // The leftmost node has no left child (and the rightmost no right one),
+  // so it is unlinked without looking for a successor.
+  void pop_front() noexcept { erase(const_iterator(header_.left)); }
+
+  void pop_back() noexcept { erase(const_iterator(header_.right)); }
 
   bool empty() const noexcept { return node_count_ == 0; }
 
@@ -282,92 +691,1076 @@ class RBTree {
     return const_iterator(upper_bound_(key));
   }
 
-  size_type count(const Key& key) const noexcept {
-    std::pair<const_iterator, const_iterator> r_pair = equal_range(key);
-    size_type n_nodes = 0;
-    for (; r_pair.first != r_pair.second; ++r_pair.first, ++n_nodes)
-      ;
-    return n_nodes;
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  iterator find(const K& key) noexcept {
+    return iterator(find_(key));
   }
 
-  void merge_unique(RBTree& other) {
-    int i = 0;
-    iterator to_delete[other.size()];
-    for (auto it = other.begin(); it != other.end(); ++it) {
-      auto pair_found = insert_unique(*it);
-      if (pair_found.second) {
-        to_delete[i++] = it;
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  const_iterator find(const K& key) const noexcept {
+    return const_iterator(find_(key));
+  }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  std::pair<iterator, iterator> equal_range(const K& key) noexcept {
+    return std::make_pair(iterator(lower_bound_(key)),
+                          iterator(upper_bound_(key)));
+  }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  std::pair<const_iterator, const_iterator> equal_range(
+      const K& key) const noexcept {
+    return std::make_pair(const_iterator(lower_bound_(key)),
+                          const_iterator(upper_bound_(key)));
+  }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  iterator lower_bound(const K& key) noexcept {
+    return iterator(lower_bound_(key));
+  }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  const_iterator lower_bound(const K& key) const noexcept {
+    return const_iterator(lower_bound_(key));
+  }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  iterator upper_bound(const K& key) noexcept {
+    return iterator(upper_bound_(key));
+  }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  const_iterator upper_bound(const K& key) const noexcept {
+    return const_iterator(upper_bound_(key));
+  }
+
+  size_type count(const Key& key) const noexcept { return count_(key); }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  size_type count(const K& key) const noexcept {
+    return count_(key);
+  }
+
+  bool contains(const Key& key) const noexcept {
+    return find_(key) != Header();
+  }
+
+  template <typename K, typename = RequireTransparent<Compare, K>>
+  bool contains(const K& key) const noexcept {
+    return find_(key) != Header();
+  }
+
+  // Number of elements that compare less than key.
+  size_type rank(const Key& key) const noexcept {
+    static_assert(OrderStatistic, "rank() needs an order-statistic tree");
+    size_type n_less = 0;
+    BasePtr curr_node = header_.parent();
+    while (curr_node) {
+      if (compare_(GetKey(curr_node), key)) {
+        n_less += SubtreeSize(curr_node->left) + 1;
+        curr_node = curr_node->right;
+      } else {
+        curr_node = curr_node->left;
+      }
+    }
+    return n_less;
+  }
+
+  // The element at in-order position pos, or end() if there is none.
+  iterator select(size_type pos) noexcept { return iterator(select_(pos)); }
+
+  const_iterator select(size_type pos) const noexcept {
+    return const_iterator(select_(pos));
+  }
+
+  // combine() of lift() over the elements with keys in [lower, upper).
+  template <typename Aug = Augment>
+  typename Aug::value_type aggregate(const Key& lower,
+                                     const Key& upper) const noexcept {
+    BasePtr split = header_.parent();
+    while (split) {
+      if (compare_(GetKey(split), lower)) {
+        split = split->right;
+      } else if (!compare_(GetKey(split), upper)) {
+        split = split->left;
+      } else {
+        break;
+      }
+    }
+    if (!split) {
+      return Augment::identity();
+    }
+    auto below = Augment::identity();
+    for (BasePtr node = split->left; node;) {
+      if (compare_(GetKey(node), lower)) {
+        node = node->right;
+      } else {
+        below = Augment::combine(
+            Augment::combine(Lift(node), SubtreeAggregate(node->right)),
+            below);
+        node = node->left;
       }
     }
-    while (i) {
-      other.erase(to_delete[--i]);
+    auto above = Augment::identity();
+    for (BasePtr node = split->right; node;) {
+      if (!compare_(GetKey(node), upper)) {
+        node = node->left;
+      } else {
+        above = Augment::combine(
+            above, Augment::combine(SubtreeAggregate(node->left), Lift(node)));
+        node = node->right;
+      }
     }
+    return Augment::combine(Augment::combine(below, Lift(split)), above);
   }
 
-  void merge_equal(RBTree& other) {
-    for (auto& val : other) {
-      insert_equal(val);
+  // In-order position of the element, size() for end().
+  size_type index_of(const RBTreeIteratorBase& position) const noexcept {
+    static_assert(OrderStatistic, "index_of() needs an order-statistic tree");
+    BasePtr node = position.node;
+    if (node == Header()) {
+      return node_count_;
+    }
+    size_type index = SubtreeSize(node->left);
+    for (; node != header_.parent(); node = node->parent()) {
+      if (node == node->parent()->right) {
+        index += SubtreeSize(node->parent()->left) + 1;
+      }
     }
-    other.clear();
+    return index;
   }
 
-  std::pair<iterator, bool> insert_unique(const Value& val) {
-    BasePtr curr_node = base_->parent, prev_node = base_;
-    bool cmp = true;
-    while (curr_node) {
-      prev_node = curr_node;
-      cmp = compare_(KeyOfValue()(val), GetKey(curr_node));
-      curr_node = cmp ? curr_node->left : curr_node->right;
+  difference_type distance(const RBTreeIteratorBase& first,
+                           const RBTreeIteratorBase& last) const noexcept {
+    return static_cast<difference_type>(index_of(last)) -
+           static_cast<difference_type>(index_of(first));
+  }
+
+  // Unlinks the element without destroying it; the handle owns it now.
+  node_type extract(const_iterator position) noexcept {
+    BasePtr node = EraseRebalance(position.node);
+    --node_count_;
+    return node_type(static_cast<NodePtr>(node), allocator_);
+  }
+
+  node_type extract(const Key& key) noexcept {
+    BasePtr node = find_(key);
+    return node == Header() ? node_type() : extract(const_iterator(node));
+  }
+
+  // Links the handle's node in as it is. Only when the handle comes from a
+  // tree with an allocator that cannot free this tree's nodes is the value
+  // moved into a node of our own.
+  insert_return_type insert_unique(node_type&& handle) {
+    if (handle.empty()) {
+      return insert_return_type{end(), false, node_type()};
     }
-    auto it = iterator(prev_node);
-    if (cmp) {
-      if (it == begin()) {
-        return std::pair<iterator, bool>(insert_(curr_node, prev_node, val),
-                                         true);
-      } else {
-        --it;
+    std::pair<BasePtr, BasePtr> pos =
+        InsertUniquePos(KeyOfValue()(handle.value()));
+    if (!pos.second) {
+      return insert_return_type{iterator(pos.first), false, std::move(handle)};
+    }
+    return insert_return_type{
+        InsertNode(pos.first, pos.second, AdoptNode(handle)), true,
+        node_type()};
+  }
+
+  iterator insert_equal(node_type&& handle) {
+    if (handle.empty()) {
+      return end();
+    }
+    std::pair<BasePtr, BasePtr> pos =
+        InsertEqualPos(KeyOfValue()(handle.value()));
+    return InsertNode(pos.first, pos.second, AdoptNode(handle));
+  }
+
+  // Moves every element whose key is not here yet over from other; the
+  // nodes are relinked, not copied. When other is not much smaller than
+  // this tree, both are flattened and rebuilt in O(n + m) instead.
+  void merge_unique(RBTree& other) {
+    if (this == &other) {
+      return;
+    }
+    if (PreferLinearMerge(other)) {
+      LinearMerge(other, true);
+      return;
+    }
+    BasePtr node = other.header_.left;
+    while (node != other.Header()) {
+      BasePtr next = NextNode(node);
+      std::pair<BasePtr, BasePtr> pos = InsertUniquePos(GetKey(node));
+      if (pos.second) {
+        node_type handle = other.extract(const_iterator(node));
+        InsertNode(pos.first, pos.second, AdoptNode(handle));
       }
+      node = next;
+    }
+  }
+
+  void merge_equal(RBTree& other) {
+    if (this == &other) {
+      return;
+    }
+    if (PreferLinearMerge(other)) {
+      LinearMerge(other, false);
+      return;
+    }
+    while (!other.empty()) {
+      node_type handle = other.extract(other.cbegin());
+      std::pair<BasePtr, BasePtr> pos =
+          InsertEqualPos(KeyOfValue()(handle.value()));
+      InsertNode(pos.first, pos.second, AdoptNode(handle));
     }
-    if (compare_(GetKey(it.node), KeyOfValue()(val))) {
-      return std::pair<iterator, bool>(insert_(curr_node, prev_node, val),
-                                       true);
+  }
+
+  // Moves the elements that are not less than key into the returned tree.
+  // Relinking takes O(log n); knowing the two sizes takes O(log n) more in
+  // an order-statistic tree and O(min(k, n - k)) otherwise.
+  RBTree split(const Key& key) {
+    RBTree upper;
+    upper.compare_ = compare_;
+    upper.allocator_ = allocator_;
+    BasePtr bound = lower_bound_(key);
+    if (bound == header_.left) {
+      SwapHeaders(upper);
+    } else if (bound != Header()) {
+      size_type n_lower = CountBefore(bound), n_total = node_count_;
+      Subtree lower, rest;
+      SplitSubtree(Subtree{Root(), BlackHeight(Root())}, key, lower, rest);
+      AttachRoot(lower.root, n_lower);
+      upper.AttachRoot(rest.root, n_total - n_lower);
     }
-    return std::pair<iterator, bool>(it, false);
+    return upper;
+  }
+
+  // Appends all of other, whose keys must sort after ours, in O(log n + log
+  // m); other is left empty. Trees whose allocators cannot free each
+  // other's nodes fall back to moving the values over one by one.
+  void join_unique(RBTree& other) { Join(other, true); }
+
+  void join_equal(RBTree& other) { Join(other, false); }
+
+  std::pair<iterator, bool> insert_unique(const Value& val) {
+    return try_emplace_unique(KeyOfValue()(val), val);
+  }
+
+  std::pair<iterator, bool> insert_unique(Value&& val) {
+    return try_emplace_unique(KeyOfValue()(val), std::move(val));
   }
 
   std::pair<iterator, bool> insert_equal(const Value& val) {
-    BasePtr prev_node = base_, curr_node = base_->parent;
-    while (curr_node) {
-      prev_node = curr_node;
-      curr_node = compare_(KeyOfValue()(val), GetKey(curr_node))
-                      ? curr_node->left
-                      : curr_node->right;
+    std::pair<BasePtr, BasePtr> pos = InsertEqualPos(KeyOfValue()(val));
+    return std::make_pair(insert_(pos.first, pos.second, val), true);
+  }
+
+  std::pair<iterator, bool> insert_equal(Value&& val) {
+    std::pair<BasePtr, BasePtr> pos = InsertEqualPos(KeyOfValue()(val));
+    return std::make_pair(insert_(pos.first, pos.second, std::move(val)),
+                          true);
+  }
+
+  // Finds the place for key in one descent and builds the value from args
+  // only when key is not there yet; key is not used once the value is
+  // built, so args may move from it.
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace_unique(const Key& key,
+                                               Args&&... args) {
+    std::pair<BasePtr, BasePtr> pos = InsertUniquePos(key);
+    if (!pos.second) {
+      return std::pair<iterator, bool>(iterator(pos.first), false);
+    }
+    return std::pair<iterator, bool>(
+        InsertNode(pos.first, pos.second,
+                   CreateNode(std::forward<Args>(args)...)),
+        true);
+  }
+
+  template <typename... Args>
+  iterator try_emplace_hint_unique(const_iterator hint, const Key& key,
+                                   Args&&... args) {
+    std::pair<BasePtr, BasePtr> pos = HintUniquePos(hint.node, key);
+    if (!pos.second) {
+      return iterator(pos.first);
     }
-    return std::make_pair(insert_(curr_node, prev_node, val), true);
+    return InsertNode(pos.first, pos.second,
+                      CreateNode(std::forward<Args>(args)...));
   }
 
-  void erase(iterator position) {
+  // When the key can be read off args, which holds for a whole value and
+  // for a key and a mapped value in a map, the search comes first and
+  // nothing is built for a key that is taken. Otherwise the node is made
+  // first and dropped again.
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_unique(Args&&... args) {
+    if constexpr (kKeyInArgs<Args...>) {
+      return try_emplace_unique(KeyInArgs(args...),
+                                std::forward<Args>(args)...);
+    }
+    NodePtr new_node = CreateNode(std::forward<Args>(args)...);
+    std::pair<BasePtr, BasePtr> pos = InsertUniquePos(GetKey(new_node));
+    if (!pos.second) {
+      DestroyNode(new_node);
+      return std::pair<iterator, bool>(iterator(pos.first), false);
+    }
+    return std::pair<iterator, bool>(
+        InsertNode(pos.first, pos.second, new_node), true);
+  }
+
+  // Hinted inserts take O(1) plus rebalancing when val belongs right before
+  // hint (or right after it) and fall back to a full descent otherwise.
+  iterator insert_unique(const_iterator hint, const Value& val) {
+    return try_emplace_hint_unique(hint, KeyOfValue()(val), val);
+  }
+
+  iterator insert_unique(const_iterator hint, Value&& val) {
+    return try_emplace_hint_unique(hint, KeyOfValue()(val), std::move(val));
+  }
+
+  iterator insert_equal(const_iterator hint, const Value& val) {
+    std::pair<BasePtr, BasePtr> pos =
+        HintEqualPos(hint.node, KeyOfValue()(val));
+    return insert_(pos.first, pos.second, val);
+  }
+
+  iterator insert_equal(const_iterator hint, Value&& val) {
+    std::pair<BasePtr, BasePtr> pos =
+        HintEqualPos(hint.node, KeyOfValue()(val));
+    return insert_(pos.first, pos.second, std::move(val));
+  }
+
+  template <typename... Args>
+  iterator emplace_hint_unique(const_iterator hint, Args&&... args) {
+    if constexpr (kKeyInArgs<Args...>) {
+      return try_emplace_hint_unique(hint, KeyInArgs(args...),
+                                     std::forward<Args>(args)...);
+    }
+    NodePtr new_node = CreateNode(std::forward<Args>(args)...);
+    std::pair<BasePtr, BasePtr> pos =
+        HintUniquePos(hint.node, GetKey(new_node));
+    if (!pos.second) {
+      DestroyNode(new_node);
+      return iterator(pos.first);
+    }
+    return InsertNode(pos.first, pos.second, new_node);
+  }
+
+  template <typename... Args>
+  iterator emplace_equal(Args&&... args) {
+    NodePtr new_node = CreateNode(std::forward<Args>(args)...);
+    std::pair<BasePtr, BasePtr> pos = InsertEqualPos(GetKey(new_node));
+    return InsertNode(pos.first, pos.second, new_node);
+  }
+
+  template <typename... Args>
+  iterator emplace_hint_equal(const_iterator hint, Args&&... args) {
+    NodePtr new_node = CreateNode(std::forward<Args>(args)...);
+    std::pair<BasePtr, BasePtr> pos =
+        HintEqualPos(hint.node, GetKey(new_node));
+    return InsertNode(pos.first, pos.second, new_node);
+  }
+
+  // Applies func to the element at position in place and brings the
+  // aggregates on its path to the root up to date, in O(log n), even when
+  // func throws. func must not change the element's key.
+  template <typename Func>
+  void modify(const_iterator position, Func func) {
+    BasePtr node = position.node;
+    if constexpr (kHasAggregate) {
+      try {
+        func(static_cast<NodePtr>(node)->m_data);
+      } catch (...) {
+        UpdatePath(node);
+        throw;
+      }
+      UpdatePath(node);
+    } else {
+      func(static_cast<NodePtr>(node)->m_data);
+    }
+  }
+
+  // No search and amortized O(1) rebalancing; returns the element after.
+  iterator erase(const_iterator position) noexcept {
+    BasePtr next = NextNode(position.node);
     auto node_to_delete = EraseRebalance(position.node);
-    delete node_to_delete;
+    DestroyNode(static_cast<NodePtr>(node_to_delete));
     --node_count_;
+    return iterator(next);
   }
 
-  void erase(const Key& key) {
-    std::pair<iterator, iterator> r_pair = equal_range(key);
-    if (r_pair.first == begin() && r_pair.second == end()) {
-      clear();
+  iterator erase(const_iterator first, const_iterator last) {
+    EraseRange(first.node, last.node);
+    return iterator(last.node);
+  }
+
+  size_type erase(const Key& key) {
+    return EraseRange(lower_bound_(key), upper_bound_(key));
+  }
+
+  // Removes the elements pred holds for in a single in-order pass. How
+  // many go is only known once pred has seen them all, and relinking loses
+  // to erasing node by node unless most of a small tree goes, so there is
+  // no rebuild here. When pred throws, the elements it has not seen yet all
+  // stay.
+  template <typename Pred>
+  size_type erase_if(Pred pred) {
+    size_type n_total = node_count_;
+    for (BasePtr node = header_.left; node != Header();) {
+      const Value& value = static_cast<NodePtr>(node)->m_data;
+      node = pred(value) ? erase(const_iterator(node)).node : NextNode(node);
+    }
+    return n_total - node_count_;
+  }
+
+ protected:
+  using NodeAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+  template <typename NodeAllocator, typename = void>
+  struct IsNodePool : std::false_type {};
+
+  template <typename NodeAllocator>
+  struct IsNodePool<NodeAllocator,
+                    std::void_t<decltype(std::declval<NodeAllocator&>()
+                                             .release()),
+                                decltype(std::declval<NodeAllocator&>()
+                                             .in_use())>> : std::true_type {};
+
+  // Trees whose node allocator is a node pool hand their nodes back in bulk
+  // when they are the pool's only user.
+  static constexpr bool kPooled = IsNodePool<NodeAlloc>::value;
+
+  BasePtr Header() const noexcept { return const_cast<BasePtr>(&header_); }
+
+  BasePtr Root() const noexcept { return header_.parent(); }
+
+  const Compare& KeyCompare() const noexcept { return compare_; }
+
+  void ResetHeader() noexcept {
+    header_.set_color(ColorType::kRed);
+    header_.set_parent(nullptr);
+    header_.left = header_.right = Header();
+    node_count_ = 0;
+  }
+
+  void SwapHeaders(RBTree& other) noexcept {
+    BasePtr root = header_.parent();
+    header_.set_parent(other.header_.parent());
+    other.header_.set_parent(root);
+    std::swap(header_.left, other.header_.left);
+    std::swap(header_.right, other.header_.right);
+    std::swap(node_count_, other.node_count_);
+    FixHeader();
+    other.FixHeader();
+  }
+
+  // After the header's links were swapped with another tree the root (or,
+  // for an empty tree, the header itself) still points at the old header.
+  void FixHeader() noexcept {
+    if (header_.parent()) {
+      header_.parent()->set_parent(Header());
     } else {
-      while (r_pair.first != r_pair.second) {
-        erase(r_pair.first++);
+      header_.left = header_.right = Header();
+    }
+  }
+
+  template <typename... Args>
+  NodePtr CreateNode(Args&&... args) {
+    NodePtr node = NodeTraits::allocate(allocator_, 1);
+    try {
+      NodeTraits::construct(allocator_, std::addressof(node->m_data),
+                            std::forward<Args>(args)...);
+    } catch (...) {
+      NodeTraits::deallocate(allocator_, node, 1);
+      throw;
+    }
+    return node;
+  }
+
+  void DestroyNode(NodePtr node) noexcept {
+    NodeTraits::destroy(allocator_, std::addressof(node->m_data));
+    NodeTraits::deallocate(allocator_, node, 1);
+  }
+
+  // Augmented trees keep per-subtree data in their nodes; Update() rebuilds
+  // it for one node from its children and UpdatePath() for all ancestors.
+  static constexpr bool kHasAggregate =
+      !std::is_same_v<Augment, Augments::None>;
+  static constexpr bool kAugmented = OrderStatistic || kHasAggregate;
+
+  static size_type SubtreeSize(BasePtr node) noexcept {
+    return node ? static_cast<NodePtr>(node)->subtree_size : 0;
+  }
+
+  template <typename Aug = Augment>
+  static typename Aug::value_type Lift(BasePtr node) noexcept {
+    return Augment::lift(static_cast<NodePtr>(node)->m_data);
+  }
+
+  template <typename Aug = Augment>
+  static typename Aug::value_type SubtreeAggregate(BasePtr node) noexcept {
+    return node ? static_cast<NodePtr>(node)->aggregate : Augment::identity();
+  }
+
+  static void Update(BasePtr node) noexcept {
+    if constexpr (OrderStatistic) {
+      static_cast<NodePtr>(node)->subtree_size =
+          SubtreeSize(node->left) + SubtreeSize(node->right) + 1;
+    }
+    if constexpr (kHasAggregate) {
+      static_cast<NodePtr>(node)->aggregate = Augment::combine(
+          Augment::combine(SubtreeAggregate(node->left), Lift(node)),
+          SubtreeAggregate(node->right));
+    }
+  }
+
+  void UpdatePath(BasePtr node) noexcept {
+    for (; node != Header(); node = node->parent()) {
+      Update(node);
+    }
+  }
+
+  BasePtr select_(size_type pos) const noexcept {
+    static_assert(OrderStatistic, "select() needs an order-statistic tree");
+    BasePtr curr_node = header_.parent();
+    while (curr_node) {
+      size_type left_size = SubtreeSize(curr_node->left);
+      if (pos < left_size) {
+        curr_node = curr_node->left;
+      } else if (pos == left_size) {
+        return curr_node;
+      } else {
+        pos -= left_size + 1;
+        curr_node = curr_node->right;
       }
     }
+    return Header();
   }
 
- protected:
   static const Key& GetKey(BasePtr node) noexcept {
     return KeyOfValue()(static_cast<NodePtr>(node)->m_data);
   }
 
+  template <typename Iter>
+  static constexpr bool kForwardIter = std::is_base_of_v<
+      std::forward_iterator_tag,
+      typename std::iterator_traits<Iter>::iterator_category>;
+
+  // Whether emplace args carry the key as they are: a whole value, or a key
+  // followed by the mapped value when values are key-first pairs.
+  template <typename... Args>
+  static constexpr bool IsKeyInArgs() noexcept {
+    if constexpr (sizeof...(Args) == 1) {
+      return (std::is_same_v<std::decay_t<Args>, Value> && ...);
+    } else if constexpr (sizeof...(Args) == 2) {
+      return std::is_same_v<KeyOfValue, KeyGetters::SelectFirst<Value>> &&
+             std::is_same_v<
+                 std::decay_t<std::tuple_element_t<0, std::tuple<Args...>>>,
+                 Key>;
+    } else {
+      return false;
+    }
+  }
+
+  template <typename... Args>
+  static constexpr bool kKeyInArgs = IsKeyInArgs<Args...>();
+
+  static const Key& KeyInArgs(const Value& val) noexcept {
+    return KeyOfValue()(val);
+  }
+
+  template <typename Mapped>
+  static const Key& KeyInArgs(const Key& key, const Mapped&) noexcept {
+    return key;
+  }
+
+  template <typename InputIt>
+  void AssignRange(InputIt first, InputIt last, bool unique) {
+    clear();
+    RBTreeNodeBase chain;
+    BasePtr tail = &chain;
+    size_type count = 0;
+    bool in_order = true;
+    NodePtr slots = nullptr;
+    size_type n_slots = 0, used = 0;
+    if constexpr (kPooled && kForwardIter<InputIt>) {
+      n_slots = static_cast<size_type>(std::distance(first, last));
+      slots = n_slots ? NodeTraits::allocate(allocator_, n_slots) : nullptr;
+    }
+    try {
+      for (; first != last; ++first) {
+        if (tail != &chain) {
+          if (compare_(KeyOfValue()(*first), GetKey(tail))) {
+            in_order = false;
+          } else if (unique && !compare_(GetKey(tail), KeyOfValue()(*first))) {
+            continue;
+          }
+        }
+        NodePtr node;
+        if (used != n_slots) {
+          node = slots + used;
+          NodeTraits::construct(allocator_, std::addressof(node->m_data),
+                                *first);
+          ++used;
+        } else {
+          node = CreateNode(*first);
+        }
+        tail->right = node;
+        tail = node;
+        ++count;
+      }
+    } catch (...) {
+      tail->right = nullptr;
+      DestroyChain(chain.right);
+      if (used != n_slots) {
+        NodeTraits::deallocate(allocator_, slots + used, n_slots - used);
+      }
+      throw;
+    }
+    if (used != n_slots) {
+      NodeTraits::deallocate(allocator_, slots + used, n_slots - used);
+    }
+    tail->right = nullptr;
+    if (!in_order) {
+      chain.right = SortChain(chain.right, count);
+      if (unique) {
+        count = DropEqualNeighbours(chain.right, count);
+      }
+    }
+    LinkChain(chain.right, count);
+  }
+
+  static bool KeepsLhsOnly(SetOperation op) noexcept {
+    return op != SetOperation::kIntersection;
+  }
+
+  static bool KeepsRhsOnly(SetOperation op) noexcept {
+    return op == SetOperation::kUnion ||
+           op == SetOperation::kSymmetricDifference;
+  }
+
+  static bool KeepsCommon(SetOperation op) noexcept {
+    return op == SetOperation::kUnion || op == SetOperation::kIntersection;
+  }
+
+  // Makes the tree out of a sorted chain of count nodes strung through
+  // right, replacing whatever the header pointed to.
+  void LinkChain(BasePtr first, size_type count) noexcept {
+    ResetHeader();
+    if (count == 0) {
+      return;
+    }
+    int red_depth =
+        (count & (count + 1)) != 0 ? static_cast<int>(FloorLog2(count)) : -1;
+    BasePtr root = BuildBalanced(count, first, 0, red_depth);
+    header_.set_parent(root);
+    root->set_parent(Header());
+    header_.left = GetMinNode(root);
+    header_.right = GetMaxNode(root);
+    node_count_ = count;
+  }
+
+  // Strings the nodes of a subtree through right in key order.
+  static void FlattenTree(BasePtr root, BasePtr& tail) noexcept {
+    while (root) {
+      BasePtr right = root->right;
+      FlattenTree(root->left, tail);
+      tail->right = root;
+      tail = root;
+      root = right;
+    }
+  }
+
+  // Whether relinking all of a tree of total nodes beats touching changed
+  // of them one by one: changed log(total) > total.
+  static bool PreferRebuild(size_type changed, size_type total) noexcept {
+    return changed * FloorLog2(total) > total;
+  }
+
+  static size_type FloorLog2(size_type n) noexcept {
+    size_type log = 0;
+    for (; n > 1; n >>= 1) {
+      ++log;
+    }
+    return log;
+  }
+
+  bool PreferLinearMerge(const RBTree& other) const noexcept {
+    if (!NodeTraits::is_always_equal::value &&
+        !(allocator_ == other.allocator_)) {
+      return false;
+    }
+    return PreferRebuild(other.node_count_, node_count_ + other.node_count_);
+  }
+
+  // Flattens both trees, merges the chains and builds both trees again.
+  // Equal elements from other go after ours; with unique set they stay in
+  // other instead.
+  void LinearMerge(RBTree& other, bool unique) noexcept {
+    RBTreeNodeBase ours, theirs, merged, rest;
+    BasePtr tail = &ours;
+    FlattenTree(header_.parent(), tail);
+    tail->right = nullptr;
+    tail = &theirs;
+    FlattenTree(other.header_.parent(), tail);
+    tail->right = nullptr;
+    BasePtr lhs = ours.right, rhs = theirs.right;
+    BasePtr merged_tail = &merged, rest_tail = &rest;
+    size_type n_merged = 0, n_rest = 0;
+    while (lhs || rhs) {
+      if (lhs && (!rhs || !compare_(GetKey(rhs), GetKey(lhs)))) {
+        merged_tail->right = lhs;
+        merged_tail = lhs;
+        lhs = lhs->right;
+        ++n_merged;
+      } else if (unique && merged_tail != &merged &&
+                 !compare_(GetKey(merged_tail), GetKey(rhs))) {
+        rest_tail->right = rhs;
+        rest_tail = rhs;
+        rhs = rhs->right;
+        ++n_rest;
+      } else {
+        merged_tail->right = rhs;
+        merged_tail = rhs;
+        rhs = rhs->right;
+        ++n_merged;
+      }
+    }
+    merged_tail->right = rest_tail->right = nullptr;
+    LinkChain(merged.right, n_merged);
+    other.LinkChain(rest.right, n_rest);
+  }
+
+  // A detached subtree and its black height, which counts the black nodes
+  // on every path from root down to a null link.
+  struct Subtree {
+    BasePtr root;
+    int height;
+  };
+
+  static int BlackHeight(BasePtr node) noexcept {
+    int height = 0;
+    for (; node; node = node->left) {
+      height += node->color() == ColorType::kBlack;
+    }
+    return height;
+  }
+
+  size_type CountBefore(BasePtr bound) const noexcept {
+    if constexpr (OrderStatistic) {
+      return index_of(RBTreeIteratorBase(bound));
+    } else {
+      // Walks both sides in lockstep and stops at the shorter one.
+      BasePtr lower = header_.left, upper = bound;
+      size_type steps = 0;
+      while (lower != bound && upper != Header()) {
+        lower = NextNode(lower);
+        upper = NextNode(upper);
+        ++steps;
+      }
+      return lower == bound ? steps : node_count_ - steps;
+    }
+  }
+
+  void AttachRoot(BasePtr root, size_type count) noexcept {
+    ResetHeader();
+    if (root) {
+      root->set_color(ColorType::kBlack);
+      root->set_parent(Header());
+      header_.set_parent(root);
+      header_.left = GetMinNode(root);
+      header_.right = GetMaxNode(root);
+      node_count_ = count;
+    }
+  }
+
+  // Splits a subtree into the keys less than key and the rest. The joins on
+  // the way up cost the difference of the heights they join, which adds up
+  // to O(log n) over the whole descent.
+  template <typename K>
+  void SplitSubtree(Subtree tree, const K& key, Subtree& lower,
+                    Subtree& upper) noexcept {
+    if (!tree.root) {
+      lower = upper = Subtree{nullptr, 0};
+      return;
+    }
+    BasePtr mid = tree.root;
+    int child_height =
+        tree.height - (mid->color() == ColorType::kBlack ? 1 : 0);
+    Subtree left{mid->left, child_height}, right{mid->right, child_height};
+    if (!compare_(GetKey(mid), key)) {
+      SplitSubtree(left, key, lower, left);
+      upper = JoinSubtrees(left, mid, right);
+    } else {
+      SplitSubtree(right, key, right, upper);
+      lower = JoinSubtrees(left, mid, right);
+    }
+  }
+
+  // Links lhs < mid < rhs into one valid subtree in O(|lhs.height -
+  // rhs.height| + 1): mid goes in red where the taller side's spine reaches
+  // the black height of the other, and an insert fix-up takes it from
+  // there. The header holds the working root meanwhile, so rotations can
+  // replace it.
+  Subtree JoinSubtrees(Subtree lhs, BasePtr mid, Subtree rhs) noexcept {
+    BlackenRoot(lhs);
+    BlackenRoot(rhs);
+    BasePtr root = mid;
+    int height = lhs.height + 1;
+    if (lhs.height > rhs.height) {
+      BasePtr parent = lhs.root;
+      height = lhs.height - 1;
+      while (parent->right && (height > rhs.height ||
+                               parent->right->color() == ColorType::kRed)) {
+        parent = parent->right;
+        height -= parent->color() == ColorType::kBlack ? 1 : 0;
+      }
+      LinkChildren(mid, parent->right, rhs.root);
+      parent->right = mid;
+      mid->set_parent(parent);
+      root = lhs.root;
+      height = lhs.height;
+    } else if (lhs.height < rhs.height) {
+      BasePtr parent = rhs.root;
+      height = rhs.height - 1;
+      while (parent->left && (height > lhs.height ||
+                              parent->left->color() == ColorType::kRed)) {
+        parent = parent->left;
+        height -= parent->color() == ColorType::kBlack ? 1 : 0;
+      }
+      LinkChildren(mid, lhs.root, parent->left);
+      parent->left = mid;
+      mid->set_parent(parent);
+      root = rhs.root;
+      height = rhs.height;
+    } else {
+      LinkChildren(mid, lhs.root, rhs.root);
+      mid->set_color(ColorType::kBlack);
+      if constexpr (kAugmented) {
+        Update(mid);
+      }
+      return Subtree{mid, height};
+    }
+    header_.set_parent(root);
+    root->set_parent(Header());
+    if constexpr (kAugmented) {
+      UpdatePath(mid);
+    }
+    if (InsertRebalance(mid)) {
+      ++height;
+    }
+    return Subtree{header_.parent(), height};
+  }
+
+  static void BlackenRoot(Subtree& tree) noexcept {
+    if (tree.root && tree.root->color() == ColorType::kRed) {
+      tree.root->set_color(ColorType::kBlack);
+      ++tree.height;
+    }
+  }
+
+  static void LinkChildren(BasePtr node, BasePtr left, BasePtr right) noexcept {
+    node->left = left;
+    node->right = right;
+    if (left) {
+      left->set_parent(node);
+    }
+    if (right) {
+      right->set_parent(node);
+    }
+  }
+
+  void Join(RBTree& other, bool unique) {
+    if (this == &other || other.empty()) {
+      return;
+    }
+    if (!empty() && (unique ? !compare_(GetKey(header_.right),
+                                        GetKey(other.header_.left))
+                            : compare_(GetKey(other.header_.left),
+                                       GetKey(header_.right)))) {
+      throw std::invalid_argument("Joined trees overlap");
+    }
+    if (!NodeTraits::is_always_equal::value &&
+        !(allocator_ == other.allocator_)) {
+      while (!other.empty()) {
+        node_type handle = other.extract(other.cbegin());
+        std::pair<BasePtr, BasePtr> pos =
+            HintEqualPos(Header(), KeyOfValue()(handle.value()));
+        InsertNode(pos.first, pos.second, AdoptNode(handle));
+      }
+      return;
+    }
+    if (empty()) {
+      SwapHeaders(other);
+      return;
+    }
+    size_type count = node_count_ + other.node_count_;
+    BasePtr mid = other.EraseRebalance(other.header_.left);
+    Subtree lhs{Root(), BlackHeight(Root())};
+    Subtree rhs{other.Root(), BlackHeight(other.Root())};
+    other.ResetHeader();
+    Subtree joined = JoinSubtrees(lhs, mid, rhs);
+    AttachRoot(joined.root, count);
+  }
+
+  // Flattening and relinking the tree beats erasing node by node only
+  // while the tree stays in cache and at least half of it goes. On int maps
+  // it measured twice as fast from half erased at 30k nodes and from 90%
+  // at 100k, but up to twice as slow at 200k nodes and up for any share.
+  static constexpr size_type kRebuildMaxNodes = size_type(1) << 16;
+
+  // Erases [first, last), relinking the rest instead of rebalancing after
+  // every node when the range covers at least half of a small tree.
+  size_type EraseRange(BasePtr first, BasePtr last) noexcept {
+    if (first == header_.left && last == Header()) {
+      size_type count = node_count_;
+      clear();
+      return count;
+    }
+    size_type count = 0;
+    if (node_count_ <= kRebuildMaxNodes) {
+      for (BasePtr node = first; node != last && count * 2 < node_count_;
+           node = NextNode(node)) {
+        ++count;
+      }
+      if (count * 2 >= node_count_) {
+        return EraseRangeRebuild(first, last);
+      }
+      count = 0;
+    }
+    for (; first != last; ++count) {
+      first = erase(const_iterator(first)).node;
+    }
+    return count;
+  }
+
+  size_type EraseRangeRebuild(BasePtr first, BasePtr last) noexcept {
+    RBTreeNodeBase chain, kept;
+    BasePtr tail = &chain;
+    FlattenTree(header_.parent(), tail);
+    tail->right = nullptr;
+    tail = &kept;
+    size_type n_kept = 0, count = 0;
+    bool inside = false;
+    for (BasePtr node = chain.right; node;) {
+      BasePtr next = node->right;
+      inside = node == first || (inside && node != last);
+      if (inside) {
+        DestroyNode(static_cast<NodePtr>(node));
+        ++count;
+      } else {
+        tail->right = node;
+        tail = node;
+        ++n_kept;
+      }
+      node = next;
+    }
+    tail->right = nullptr;
+    LinkChain(kept.right, n_kept);
+    return count;
+  }
+
+  void DestroyChain(BasePtr node) noexcept {
+    while (node) {
+      BasePtr next = node->right;
+      DestroyNode(static_cast<NodePtr>(node));
+      node = next;
+    }
+  }
+
+  // Stable merge sort of a chain of n nodes strung through right.
+  BasePtr SortChain(BasePtr first, size_type n) const noexcept {
+    if (n < 2) {
+      return first;
+    }
+    BasePtr mid = first;
+    for (size_type i = 1; i < n / 2; ++i) {
+      mid = mid->right;
+    }
+    BasePtr second = mid->right;
+    mid->right = nullptr;
+    BasePtr lhs = SortChain(first, n / 2);
+    BasePtr rhs = SortChain(second, n - n / 2);
+    RBTreeNodeBase head;
+    BasePtr tail = &head;
+    while (lhs && rhs) {
+      if (compare_(GetKey(rhs), GetKey(lhs))) {
+        tail->right = rhs;
+        rhs = rhs->right;
+      } else {
+        tail->right = lhs;
+        lhs = lhs->right;
+      }
+      tail = tail->right;
+    }
+    tail->right = lhs ? lhs : rhs;
+    return head.right;
+  }
+
+  size_type DropEqualNeighbours(BasePtr node, size_type count) noexcept {
+    while (node && node->right) {
+      BasePtr next = node->right;
+      if (compare_(GetKey(node), GetKey(next))) {
+        node = next;
+      } else {
+        node->right = next->right;
+        DestroyNode(static_cast<NodePtr>(next));
+        --count;
+      }
+    }
+    return count;
+  }
+
+  // Links the next n nodes of a chain strung through right into a balanced
+  // tree. Subtree sizes differ by at most one, so every null link sits on
+  // one of the two deepest levels; colouring the deepest level red when it
+  // is not full makes every path count the same black nodes.
+  BasePtr BuildBalanced(size_type n, BasePtr& chain, int depth,
+                        int red_depth) noexcept {
+    if (n == 0) {
+      return nullptr;
+    }
+    size_type n_left = (n - 1) / 2;
+    BasePtr left = BuildBalanced(n_left, chain, depth + 1, red_depth);
+    BasePtr node = chain;
+    chain = chain->right;
+    node->left = left;
+    if (left) {
+      left->set_parent(node);
+    }
+    node->right = BuildBalanced(n - 1 - n_left, chain, depth + 1, red_depth);
+    if (node->right) {
+      node->right->set_parent(node);
+    }
+    node->set_color(depth == red_depth ? ColorType::kRed : ColorType::kBlack);
+    if constexpr (kAugmented) {
+      Update(node);
+    }
+    return node;
+  }
+
+  NodePtr AdoptNode(node_type& handle) {
+    if (NodeTraits::is_always_equal::value ||
+        handle.allocator_ == allocator_) {
+      return handle.release();
+    }
+    NodePtr node = CreateNode(std::move(handle.value()));
+    handle.reset();
+    return node;
+  }
+
+  static BasePtr PrevNode(BasePtr node) noexcept {
+    RBTreeIteratorBase it(node);
+    it.Decrement();
+    return it.node;
+  }
+
+  static BasePtr NextNode(BasePtr node) noexcept {
+    RBTreeIteratorBase it(node);
+    it.Increment();
+    return it.node;
+  }
+
   static BasePtr GetMinNode(BasePtr root) noexcept {
     while (root->left) {
       root = root->left;
@@ -381,38 +1774,113 @@ class RBTree {
     return root;
   }
 
-  static void DeleteTree(BasePtr root) {
+  // A red-black tree is at most 2 log2(n + 1) deep, so walks that keep
+  // one pending subtree per level fit a fixed stack for any tree.
+  static constexpr int kMaxDepth = 2 * std::numeric_limits<size_type>::digits;
+
+  void DeleteTree(BasePtr root) noexcept {
+    BasePtr pending[kMaxDepth];
+    int depth = 0;
     while (root) {
-      DeleteTree(root->right);
+      if (root->right) {
+        pending[depth++] = root->right;
+      }
       BasePtr left = root->left;
-      delete root;
-      root = left;
+      DestroyNode(static_cast<NodePtr>(root));
+      root = left ? left : depth ? pending[--depth] : nullptr;
     }
   }
 
-  static NodePtr CopyTree(BasePtr root, BasePtr head) {
-    auto top = new Node(*static_cast<NodePtr>(root));
-    top->parent = head;
-    if (root->right) {
-      top->right = CopyTree(root->right, top);
-    }
-    head = top;
-    root = root->left;
+  void DestroyValues(BasePtr root) noexcept {
+    BasePtr pending[kMaxDepth];
+    int depth = 0;
     while (root) {
-      auto copy = new Node(*static_cast<NodePtr>(root));
-      head->left = copy;
-      copy->parent = head;
       if (root->right) {
-        copy->right = CopyTree(root->right, copy);
+        pending[depth++] = root->right;
       }
-      head = copy;
-      root = root->left;
+      NodeTraits::destroy(allocator_,
+                          std::addressof(static_cast<NodePtr>(root)->m_data));
+      root = root->left ? root->left : depth ? pending[--depth] : nullptr;
+    }
+  }
+
+  // Copies node's value and tree fields into slot, or into a node of its
+  // own when slot is null.
+  NodePtr CloneNode(BasePtr node, NodePtr slot) {
+    NodePtr copy = slot;
+    if (copy) {
+      NodeTraits::construct(allocator_, std::addressof(copy->m_data),
+                            static_cast<NodePtr>(node)->m_data);
+    } else {
+      copy = CreateNode(static_cast<NodePtr>(node)->m_data);
+    }
+    copy->set_color(node->color());
+    copy->left = copy->right = nullptr;
+    if constexpr (OrderStatistic) {
+      copy->subtree_size = static_cast<NodePtr>(node)->subtree_size;
+    }
+    if constexpr (kHasAggregate) {
+      copy->aggregate = static_cast<NodePtr>(node)->aggregate;
+    }
+    return copy;
+  }
+
+  // Copies the count nodes under root in pre-order without recursion. A
+  // node pool hands out all of them as one contiguous block, so the copy
+  // is laid out in the order a search walks it.
+  NodePtr CopyTree(BasePtr root, BasePtr head, size_type count) {
+    NodePtr slots = nullptr;
+    size_type used = 0;
+    if constexpr (kPooled) {
+      slots = NodeTraits::allocate(allocator_, count);
+    }
+    auto clone = [&](BasePtr node, BasePtr parent) {
+      NodePtr copy = CloneNode(node, slots ? slots + used : nullptr);
+      ++used;
+      copy->set_parent(parent);
+      return copy;
+    };
+    // Right subtrees still to copy, with the copy of their parent.
+    std::pair<BasePtr, NodePtr> pending[kMaxDepth];
+    int depth = 0;
+    NodePtr top = nullptr;
+    try {
+      top = clone(root, head);
+      BasePtr src = root;
+      NodePtr dst = top;
+      while (true) {
+        if (src->right) {
+          pending[depth++] = std::make_pair(src->right, dst);
+        }
+        if (src->left) {
+          dst->left = clone(src->left, dst);
+          src = src->left;
+          dst = static_cast<NodePtr>(dst->left);
+        } else if (depth) {
+          --depth;
+          src = pending[depth].first;
+          dst = pending[depth].second;
+          dst->right = clone(src, dst);
+          dst = static_cast<NodePtr>(dst->right);
+        } else {
+          break;
+        }
+      }
+    } catch (...) {
+      if (top) {
+        DeleteTree(top);
+      }
+      if (slots && used != count) {
+        NodeTraits::deallocate(allocator_, slots + used, count - used);
+      }
+      throw;
     }
     return top;
   }
 
-  BasePtr upper_bound_(const Key& key) const noexcept {
-    BasePtr prev_node = base_, curr_node = base_->parent;
+  template <typename K>
+  BasePtr upper_bound_(const K& key) const noexcept {
+    BasePtr prev_node = Header(), curr_node = header_.parent();
     while (curr_node) {
       if (compare_(key, GetKey(curr_node))) {
         prev_node = curr_node;
@@ -424,8 +1892,9 @@ class RBTree {
     return prev_node;
   }
 
-  BasePtr lower_bound_(const Key& key) const noexcept {
-    BasePtr prev_node = base_, curr_node = base_->parent;
+  template <typename K>
+  BasePtr lower_bound_(const K& key) const noexcept {
+    BasePtr prev_node = Header(), curr_node = header_.parent();
     while (curr_node) {
       if (!compare_(GetKey(curr_node), key)) {
         prev_node = curr_node;
@@ -437,33 +1906,153 @@ class RBTree {
     return prev_node;
   }
 
-  BasePtr find_(const Key& key) const noexcept {
+  template <typename K>
+  BasePtr find_(const K& key) const noexcept {
     BasePtr found_node = lower_bound_(key);
-    if (found_node == base_ || compare_(key, GetKey(found_node))) {
-      return base_;
+    if (found_node == Header() || compare_(key, GetKey(found_node))) {
+      return Header();
     }
     return found_node;
   }
 
-  iterator insert_(BasePtr curr_node, BasePtr prev_node, const Value& val) {
-    auto new_node = new Node(val);
-    if (prev_node == base_ || curr_node ||
-        compare_(KeyOfValue()(val), GetKey(prev_node))) {
+  template <typename K>
+  size_type count_(const K& key) const noexcept {
+    std::pair<const_iterator, const_iterator> r_pair(
+        const_iterator(lower_bound_(key)), const_iterator(upper_bound_(key)));
+    if constexpr (OrderStatistic) {
+      return distance(r_pair.first, r_pair.second);
+    }
+    size_type n_nodes = 0;
+    for (; r_pair.first != r_pair.second; ++r_pair.first, ++n_nodes)
+      ;
+    return n_nodes;
+  }
+
+  // Positions are (curr_node, prev_node) pairs as insert_() takes them: the
+  // new node becomes a child of prev_node, the left one when curr_node is
+  // set. A null prev_node means an equal key already sits at curr_node.
+  std::pair<BasePtr, BasePtr> InsertUniquePos(const Key& key) const noexcept {
+    BasePtr curr_node = header_.parent(), prev_node = Header();
+    bool cmp = true;
+    while (curr_node) {
+      prev_node = curr_node;
+      cmp = compare_(key, GetKey(curr_node));
+      curr_node = cmp ? curr_node->left : curr_node->right;
+    }
+    BasePtr before = prev_node;
+    if (cmp) {
+      if (before == header_.left) {
+        return {curr_node, prev_node};
+      }
+      before = PrevNode(before);
+    }
+    if (compare_(GetKey(before), key)) {
+      return {curr_node, prev_node};
+    }
+    return {before, nullptr};
+  }
+
+  std::pair<BasePtr, BasePtr> InsertEqualPos(const Key& key) const noexcept {
+    BasePtr prev_node = Header(), curr_node = header_.parent();
+    while (curr_node) {
+      prev_node = curr_node;
+      curr_node = compare_(key, GetKey(curr_node)) ? curr_node->left
+                                                   : curr_node->right;
+    }
+    return {curr_node, prev_node};
+  }
+
+  std::pair<BasePtr, BasePtr> HintUniquePos(BasePtr hint,
+                                            const Key& key) const noexcept {
+    if (hint == Header()) {
+      if (node_count_ && compare_(GetKey(header_.right), key)) {
+        return {nullptr, header_.right};
+      }
+      return InsertUniquePos(key);
+    }
+    if (compare_(key, GetKey(hint))) {
+      if (hint == header_.left) {
+        return {hint, hint};
+      }
+      BasePtr before = PrevNode(hint);
+      if (compare_(GetKey(before), key)) {
+        return before->right ? std::pair<BasePtr, BasePtr>(hint, hint)
+                             : std::pair<BasePtr, BasePtr>(nullptr, before);
+      }
+      return InsertUniquePos(key);
+    }
+    if (compare_(GetKey(hint), key)) {
+      if (hint == header_.right) {
+        return {nullptr, hint};
+      }
+      BasePtr after = NextNode(hint);
+      if (compare_(key, GetKey(after))) {
+        return hint->right ? std::pair<BasePtr, BasePtr>(after, after)
+                           : std::pair<BasePtr, BasePtr>(nullptr, hint);
+      }
+      return InsertUniquePos(key);
+    }
+    return {hint, nullptr};
+  }
+
+  std::pair<BasePtr, BasePtr> HintEqualPos(BasePtr hint,
+                                           const Key& key) const noexcept {
+    if (hint == Header()) {
+      if (node_count_ && !compare_(key, GetKey(header_.right))) {
+        return {nullptr, header_.right};
+      }
+      return InsertEqualPos(key);
+    }
+    if (!compare_(GetKey(hint), key)) {
+      if (hint == header_.left) {
+        return {hint, hint};
+      }
+      BasePtr before = PrevNode(hint);
+      if (!compare_(key, GetKey(before))) {
+        return before->right ? std::pair<BasePtr, BasePtr>(hint, hint)
+                             : std::pair<BasePtr, BasePtr>(nullptr, before);
+      }
+      return InsertEqualPos(key);
+    }
+    if (hint == header_.right) {
+      return {nullptr, hint};
+    }
+    BasePtr after = NextNode(hint);
+    if (!compare_(GetKey(after), key)) {
+      return hint->right ? std::pair<BasePtr, BasePtr>(after, after)
+                         : std::pair<BasePtr, BasePtr>(nullptr, hint);
+    }
+    return InsertEqualPos(key);
+  }
+
+  template <typename Arg>
+  iterator insert_(BasePtr curr_node, BasePtr prev_node, Arg&& val) {
+    return InsertNode(curr_node, prev_node,
+                      CreateNode(std::forward<Arg>(val)));
+  }
+
+  iterator InsertNode(BasePtr curr_node, BasePtr prev_node,
+                      NodePtr new_node) noexcept {
+    if (prev_node == Header() || curr_node ||
+        compare_(GetKey(new_node), GetKey(prev_node))) {
       prev_node->left = new_node;
-      if (prev_node == base_) {
-        base_->parent = new_node;
-        base_->right = new_node;
-      } else if (prev_node == base_->left) {
-        base_->left = new_node;
+      if (prev_node == Header()) {
+        header_.set_parent(new_node);
+        header_.right = new_node;
+      } else if (prev_node == header_.left) {
+        header_.left = new_node;
       }
     } else {
       prev_node->right = new_node;
-      if (prev_node == base_->right) {
-        base_->right = new_node;
+      if (prev_node == header_.right) {
+        header_.right = new_node;
       }
     }
-    new_node->parent = prev_node;
+    new_node->set_parent(prev_node);
     new_node->left = new_node->right = nullptr;
+    if constexpr (kAugmented) {
+      UpdatePath(new_node);
+    }
     InsertRebalance(new_node);
     ++node_count_;
     return iterator(new_node);
@@ -473,77 +2062,89 @@ class RBTree {
     BasePtr right_child = node->right;
     node->right = right_child->left;
     if (right_child->left) {
-      right_child->left->parent = node;
+      right_child->left->set_parent(node);
     }
-    right_child->parent = node->parent;
-    if (node == base_->parent) {
-      base_->parent = right_child;
-    } else if (node == node->parent->left) {
-      node->parent->left = right_child;
+    right_child->set_parent(node->parent());
+    if (node == header_.parent()) {
+      header_.set_parent(right_child);
+    } else if (node == node->parent()->left) {
+      node->parent()->left = right_child;
     } else {
-      node->parent->right = right_child;
+      node->parent()->right = right_child;
     }
     right_child->left = node;
-    node->parent = right_child;
+    node->set_parent(right_child);
+    if constexpr (kAugmented) {
+      Update(node);
+      Update(right_child);
+    }
   }
 
   void RotateRight(BasePtr node) noexcept {
     BasePtr left_child = node->left;
     node->left = left_child->right;
     if (left_child->right) {
-      left_child->right->parent = node;
+      left_child->right->set_parent(node);
     }
-    left_child->parent = node->parent;
-    if (node == base_->parent) {
-      base_->parent = left_child;
-    } else if (node == node->parent->right) {
-      node->parent->right = left_child;
+    left_child->set_parent(node->parent());
+    if (node == header_.parent()) {
+      header_.set_parent(left_child);
+    } else if (node == node->parent()->right) {
+      node->parent()->right = left_child;
     } else {
-      node->parent->left = left_child;
+      node->parent()->left = left_child;
     }
     left_child->right = node;
-    node->parent = left_child;
+    node->set_parent(left_child);
+    if constexpr (kAugmented) {
+      Update(node);
+      Update(left_child);
+    }
   }
 
-  void InsertRebalance(BasePtr node) noexcept {
-    node->color = ColorType::kRed;
-    while (node != base_->parent && node->parent->color == ColorType::kRed) {
+  // Returns whether the black height of the tree grew.
+  bool InsertRebalance(BasePtr node) noexcept {
+    node->set_color(ColorType::kRed);
+    while (node != header_.parent() &&
+           node->parent()->color() == ColorType::kRed) {
       BasePtr uncle;
-      if (node->parent == node->parent->parent->left) {
-        uncle = node->parent->parent->right;
-        if (uncle && uncle->color == ColorType::kRed) {
-          node->parent->color = ColorType::kBlack;
-          uncle->color = ColorType::kBlack;
-          node->parent->parent->color = ColorType::kRed;
-          node = node->parent->parent;
+      if (node->parent() == node->parent()->parent()->left) {
+        uncle = node->parent()->parent()->right;
+        if (uncle && uncle->color() == ColorType::kRed) {
+          node->parent()->set_color(ColorType::kBlack);
+          uncle->set_color(ColorType::kBlack);
+          node->parent()->parent()->set_color(ColorType::kRed);
+          node = node->parent()->parent();
         } else {
-          if (node == node->parent->right) {
-            node = node->parent;
+          if (node == node->parent()->right) {
+            node = node->parent();
             RotateLeft(node);
           }
-          node->parent->color = ColorType::kBlack;
-          node->parent->parent->color = ColorType::kRed;
-          RotateRight(node->parent->parent);
+          node->parent()->set_color(ColorType::kBlack);
+          node->parent()->parent()->set_color(ColorType::kRed);
+          RotateRight(node->parent()->parent());
         }
       } else {
-        uncle = node->parent->parent->left;
-        if (uncle && uncle->color == ColorType::kRed) {
-          node->parent->color = ColorType::kBlack;
-          uncle->color = ColorType::kBlack;
-          node->parent->parent->color = ColorType::kRed;
-          node = node->parent->parent;
+        uncle = node->parent()->parent()->left;
+        if (uncle && uncle->color() == ColorType::kRed) {
+          node->parent()->set_color(ColorType::kBlack);
+          uncle->set_color(ColorType::kBlack);
+          node->parent()->parent()->set_color(ColorType::kRed);
+          node = node->parent()->parent();
         } else {
-          if (node == node->parent->left) {
-            node = node->parent;
+          if (node == node->parent()->left) {
+            node = node->parent();
             RotateRight(node);
           }
-          node->parent->color = ColorType::kBlack;
-          node->parent->parent->color = ColorType::kRed;
-          RotateLeft(node->parent->parent);
+          node->parent()->set_color(ColorType::kBlack);
+          node->parent()->parent()->set_color(ColorType::kRed);
+          RotateLeft(node->parent()->parent());
         }
       }
     }
-    base_->parent->color = ColorType::kBlack;
+    bool grown = header_.parent()->color() == ColorType::kRed;
+    header_.parent()->set_color(ColorType::kBlack);
+    return grown;
   }
 
   BasePtr EraseRebalance(BasePtr node) noexcept {
@@ -559,118 +2160,123 @@ class RBTree {
       }
     }
     if (curr_node != node) {
-      node->left->parent = curr_node;
+      node->left->set_parent(curr_node);
       curr_node->left = node->left;
       if (curr_node != node->right) {
-        pv_parent = curr_node->parent;
+        pv_parent = curr_node->parent();
         if (prev_node) {
-          curr_node->parent = curr_node->parent;
+          prev_node->set_parent(curr_node->parent());
         }
-        curr_node->parent->left = prev_node;
+        curr_node->parent()->left = prev_node;
         curr_node->right = node->right;
-        node->right->parent = curr_node;
+        node->right->set_parent(curr_node);
       } else {
         pv_parent = curr_node;
       }
-      if (base_->parent == node) {
-        base_->parent = curr_node;
-      } else if (node->parent->left == node) {
-        node->parent->left = curr_node;
+      if (header_.parent() == node) {
+        header_.set_parent(curr_node);
+      } else if (node->parent()->left == node) {
+        node->parent()->left = curr_node;
       } else {
-        node->parent->right = curr_node;
+        node->parent()->right = curr_node;
       }
-      curr_node->parent = node->parent;
-      std::swap(curr_node->color, node->color);
+      curr_node->set_parent(node->parent());
+      ColorType color = curr_node->color();
+      curr_node->set_color(node->color());
+      node->set_color(color);
       curr_node = node;
     } else {
-      pv_parent = curr_node->parent;
+      pv_parent = curr_node->parent();
       if (prev_node) {
-        prev_node->parent = curr_node->parent;
+        prev_node->set_parent(curr_node->parent());
       }
-      if (base_->parent == node) {
-        base_->parent = prev_node;
+      if (header_.parent() == node) {
+        header_.set_parent(prev_node);
       } else {
-        if (node->parent->left == node) {
-          node->parent->left = prev_node;
+        if (node->parent()->left == node) {
+          node->parent()->left = prev_node;
         } else {
-          node->parent->right = prev_node;
+          node->parent()->right = prev_node;
         }
       }
-      if (base_->left == node) {
+      if (header_.left == node) {
         if (!node->right) {
-          base_->left = node->parent;
+          header_.left = node->parent();
         } else {
-          base_->left = GetMinNode(prev_node);
+          header_.left = GetMinNode(prev_node);
         }
       }
-      if (base_->right == node) {
+      if (header_.right == node) {
         if (!node->left) {
-          base_->right = node->parent;
+          header_.right = node->parent();
         } else {
-          base_->right = GetMaxNode(prev_node);
+          header_.right = GetMaxNode(prev_node);
         }
       }
     }
-    if (curr_node->color != ColorType::kRed) {
-      while (prev_node != base_->parent &&
-             (!prev_node || prev_node->color == ColorType::kBlack)) {
+    if constexpr (kAugmented) {
+      UpdatePath(pv_parent);
+    }
+    if (curr_node->color() != ColorType::kRed) {
+      while (prev_node != header_.parent() &&
+             (!prev_node || prev_node->color() == ColorType::kBlack)) {
         BasePtr uncle;
         if (prev_node == pv_parent->left) {
           uncle = pv_parent->right;
-          if (uncle->color == ColorType::kRed) {
-            uncle->color = ColorType::kBlack;
-            pv_parent->color = ColorType::kRed;
+          if (uncle->color() == ColorType::kRed) {
+            uncle->set_color(ColorType::kBlack);
+            pv_parent->set_color(ColorType::kRed);
             RotateLeft(pv_parent);
             uncle = pv_parent->right;
           }
-          if ((!uncle->left || uncle->left->color == ColorType::kBlack) &&
-              (!uncle->right || uncle->right->color == ColorType::kBlack)) {
-            uncle->color = ColorType::kRed;
+          if ((!uncle->left || uncle->left->color() == ColorType::kBlack) &&
+              (!uncle->right || uncle->right->color() == ColorType::kBlack)) {
+            uncle->set_color(ColorType::kRed);
             prev_node = pv_parent;
-            pv_parent = pv_parent->parent;
+            pv_parent = pv_parent->parent();
           } else {
-            if (!uncle->right || uncle->right->color == ColorType::kBlack) {
+            if (!uncle->right || uncle->right->color() == ColorType::kBlack) {
               if (uncle->left) {
-                uncle->left->color = ColorType::kBlack;
+                uncle->left->set_color(ColorType::kBlack);
               }
-              uncle->color = ColorType::kRed;
+              uncle->set_color(ColorType::kRed);
               RotateRight(uncle);
               uncle = pv_parent->right;
             }
-            uncle->color = pv_parent->color;
-            pv_parent->color = ColorType::kBlack;
+            uncle->set_color(pv_parent->color());
+            pv_parent->set_color(ColorType::kBlack);
             if (uncle->right) {
-              uncle->right->color = ColorType::kBlack;
+              uncle->right->set_color(ColorType::kBlack);
             }
             RotateLeft(pv_parent);
             break;
           }
         } else {
           uncle = pv_parent->left;
-          if (uncle->color == ColorType::kRed) {
-            uncle->color = ColorType::kBlack;
-            pv_parent->color = ColorType::kRed;
+          if (uncle->color() == ColorType::kRed) {
+            uncle->set_color(ColorType::kBlack);
+            pv_parent->set_color(ColorType::kRed);
             RotateRight(pv_parent);
             uncle = pv_parent->left;
           }
-          if ((!uncle->right || uncle->right->color == ColorType::kBlack) &&
-              (!uncle->left || uncle->left->color == ColorType::kBlack)) {
-            uncle->color = ColorType::kRed;
+          if ((!uncle->right || uncle->right->color() == ColorType::kBlack) &&
+              (!uncle->left || uncle->left->color() == ColorType::kBlack)) {
+            uncle->set_color(ColorType::kRed);
             prev_node = pv_parent;
-            pv_parent = pv_parent->parent;
+            pv_parent = pv_parent->parent();
           } else {
-            if (!uncle->left || uncle->left->color == ColorType::kBlack) {
+            if (!uncle->left || uncle->left->color() == ColorType::kBlack) {
               if (uncle->right) {
-                uncle->right->color = ColorType::kBlack;
+                uncle->right->set_color(ColorType::kBlack);
               }
-              uncle->color = ColorType::kRed;
+              uncle->set_color(ColorType::kRed);
               RotateLeft(uncle);
               uncle = pv_parent->left;
             }
-            uncle->color = pv_parent->color;
-            pv_parent->color = ColorType::kBlack;
+            uncle->set_color(pv_parent->color());
+            pv_parent->set_color(ColorType::kBlack);
             if (uncle->left) {
-              uncle->left->color = ColorType::kBlack;
+              uncle->left->set_color(ColorType::kBlack);
             }
             RotateRight(pv_parent);
             break;
@@ -678,16 +2284,17 @@ class RBTree {
         }
       }
       if (prev_node) {
-        prev_node->color = ColorType::kBlack;
+        prev_node->set_color(ColorType::kBlack);
       }
     }
     return curr_node;
   }
 
  private:
+  RBTreeNodeBase header_;
   size_type node_count_{};
   Compare compare_;
-  BasePtr base_;
+  NodeAlloc allocator_;
 };
 
 }  // namespace s21
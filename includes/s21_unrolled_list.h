@@ -0,0 +1,481 @@
+#ifndef S21_CONTAINER_SRC_S21_UNROLLED_LIST_H_
+#define S21_CONTAINER_SRC_S21_UNROLLED_LIST_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace s21 {
+
+struct UnrolledListNodeBase {
+  UnrolledListNodeBase() noexcept : prev(this), next(this) {}
+
+  void hook(UnrolledListNodeBase* const pos) noexcept {
+    prev = pos->prev;
+    next = pos;
+    pos->prev->next = this;
+    pos->prev = this;
+  }
+
+  void unhook() noexcept {
+    prev->next = next;
+    next->prev = prev;
+  }
+
+  UnrolledListNodeBase* prev;
+  UnrolledListNodeBase* next;
+  size_t count{};
+};
+
+// Every node keeps up to Capacity elements in place, so a traversal touches
+// one cache line run per Capacity elements instead of one node per element.
+template <typename Tp, size_t Capacity>
+struct UnrolledListNode : public UnrolledListNodeBase {
+  Tp* data() noexcept { return std::launder(reinterpret_cast<Tp*>(storage)); }
+
+  const Tp* data() const noexcept {
+    return std::launder(reinterpret_cast<const Tp*>(storage));
+  }
+
+  alignas(Tp) unsigned char storage[sizeof(Tp) * Capacity];
+};
+
+template <typename Tp, size_t Capacity>
+struct UnrolledListIterator {
+  using Node = UnrolledListNode<Tp, Capacity>;
+  using difference_type = ptrdiff_t;
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = Tp;
+  using pointer = Tp*;
+  using reference = Tp&;
+
+  UnrolledListIterator() noexcept : node(), index() {}
+
+  UnrolledListIterator(UnrolledListNodeBase* node, size_t index) noexcept
+      : node(node), index(index) {}
+
+  reference operator*() const noexcept {
+    return static_cast<Node*>(node)->data()[index];
+  }
+
+  pointer operator->() const noexcept {
+    return static_cast<Node*>(node)->data() + index;
+  }
+
+  UnrolledListIterator& operator++() noexcept {
+    if (++index == node->count) {
+      node = node->next;
+      index = 0;
+    }
+    return *this;
+  }
+
+  UnrolledListIterator operator++(int) noexcept {
+    UnrolledListIterator ret(*this);
+    ++*this;
+    return ret;
+  }
+
+  UnrolledListIterator& operator--() noexcept {
+    if (index == 0) {
+      node = node->prev;
+      index = node->count;
+    }
+    --index;
+    return *this;
+  }
+
+  UnrolledListIterator operator--(int) noexcept {
+    UnrolledListIterator ret(*this);
+    --*this;
+    return ret;
+  }
+
+  friend bool operator==(const UnrolledListIterator& lhs,
+                         const UnrolledListIterator& rhs) noexcept {
+    return lhs.node == rhs.node && lhs.index == rhs.index;
+  }
+
+  friend bool operator!=(const UnrolledListIterator& lhs,
+                         const UnrolledListIterator& rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+  UnrolledListNodeBase* node;
+  size_t index;
+};
+
+template <typename Tp, size_t Capacity>
+struct UnrolledListConstIterator {
+  using iterator = UnrolledListIterator<Tp, Capacity>;
+  using Node = const UnrolledListNode<Tp, Capacity>;
+  using difference_type = ptrdiff_t;
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = Tp;
+  using pointer = const Tp*;
+  using reference = const Tp&;
+
+  UnrolledListConstIterator() noexcept : node(), index() {}
+
+  UnrolledListConstIterator(const UnrolledListNodeBase* node,
+                            size_t index) noexcept
+      : node(node), index(index) {}
+
+  UnrolledListConstIterator(const iterator& it) noexcept
+      : node(it.node), index(it.index) {}
+
+  iterator const_cast_() const noexcept {
+    return iterator(const_cast<UnrolledListNodeBase*>(node), index);
+  }
+
+  reference operator*() const noexcept {
+    return static_cast<Node*>(node)->data()[index];
+  }
+
+  pointer operator->() const noexcept {
+    return static_cast<Node*>(node)->data() + index;
+  }
+
+  UnrolledListConstIterator& operator++() noexcept {
+    if (++index == node->count) {
+      node = node->next;
+      index = 0;
+    }
+    return *this;
+  }
+
+  UnrolledListConstIterator operator++(int) noexcept {
+    UnrolledListConstIterator ret(*this);
+    ++*this;
+    return ret;
+  }
+
+  UnrolledListConstIterator& operator--() noexcept {
+    if (index == 0) {
+      node = node->prev;
+      index = node->count;
+    }
+    --index;
+    return *this;
+  }
+
+  UnrolledListConstIterator operator--(int) noexcept {
+    UnrolledListConstIterator ret(*this);
+    --*this;
+    return ret;
+  }
+
+  friend bool operator==(const UnrolledListConstIterator& lhs,
+                         const UnrolledListConstIterator& rhs) noexcept {
+    return lhs.node == rhs.node && lhs.index == rhs.index;
+  }
+
+  friend bool operator!=(const UnrolledListConstIterator& lhs,
+                         const UnrolledListConstIterator& rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+  const UnrolledListNodeBase* node;
+  size_t index;
+};
+
+// Insertion and erasure are O(Capacity) and only invalidate iterators into
+// the node being modified (and into its neighbour when nodes split or merge).
+template <typename Tp, size_t Capacity = 16>
+class unrolled_list {
+  static_assert(Capacity >= 2, "Node capacity must be at least 2");
+
+ public:
+  using value_type = Tp;
+  using reference = Tp&;
+  using const_reference = const Tp&;
+  using pointer = Tp*;
+  using const_pointer = const Tp*;
+  using Node = UnrolledListNode<value_type, Capacity>;
+  using iterator = UnrolledListIterator<value_type, Capacity>;
+  using const_iterator = UnrolledListConstIterator<value_type, Capacity>;
+  using size_type = size_t;
+
+  unrolled_list() noexcept = default;
+
+  explicit unrolled_list(size_type n) : unrolled_list() {
+    for (; n != 0; --n) {
+      emplace_back();
+    }
+  }
+
+  unrolled_list(std::initializer_list<value_type> const& items)
+      : unrolled_list() {
+    for (auto& item : items) {
+      push_back(item);
+    }
+  }
+
+  unrolled_list(const unrolled_list& other) : unrolled_list() {
+    for (auto& val : other) {
+      push_back(val);
+    }
+  }
+
+  unrolled_list(unrolled_list&& other) noexcept : unrolled_list() {
+    swap(other);
+  }
+
+  ~unrolled_list() { clear(); }
+
+  unrolled_list& operator=(const unrolled_list& other) {
+    if (this != &other) {
+      unrolled_list tmp(other);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  unrolled_list& operator=(unrolled_list&& other) noexcept {
+    unrolled_list tmp(std::move(other));
+    if (this != &other) {
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  void clear() noexcept {
+    while (base_.next != &base_) {
+      auto node = static_cast<Node*>(base_.next);
+      base_.next = node->next;
+      DestroyNode(node);
+    }
+    base_.prev = &base_;
+    size_ = 0;
+  }
+
+  bool empty() const noexcept { return size_ == 0; }
+
+  size_type size() const noexcept { return size_; }
+
+  size_type max_size() const noexcept {
+    return std::numeric_limits<size_type>::max() / 2 / sizeof(value_type);
+  }
+
+  reference front() noexcept { return *begin(); }
+
+  const_reference front() const noexcept { return *begin(); }
+
+  reference back() noexcept { return *--end(); }
+
+  const_reference back() const noexcept { return *--end(); }
+
+  iterator insert(const_iterator pos, const_reference value) {
+    return emplace(pos, value);
+  }
+
+  iterator insert(const_iterator pos, value_type&& value) {
+    return emplace(pos, std::move(value));
+  }
+
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args) {
+    iterator place = pos.const_cast_();
+    Node* node;
+    size_type index = place.index;
+    if (place.node == &base_) {
+      node = static_cast<Node*>(base_.prev);
+      if (node == &base_ || node->count == Capacity) {
+        node = CreateNode(&base_);
+      }
+      index = node->count;
+    } else {
+      node = static_cast<Node*>(place.node);
+      if (index == 0 && node->prev != &base_ &&
+          node->prev->count != Capacity) {
+        node = static_cast<Node*>(node->prev);
+        index = node->count;
+      } else if (node->count == Capacity) {
+        Node* half = Split(node);
+        if (index > node->count) {
+          index -= node->count;
+          node = half;
+        }
+      }
+    }
+    Tp* data = node->data();
+    if (index == node->count) {
+      try {
+        new (data + index) value_type(std::forward<Args>(args)...);
+      } catch (...) {
+        // Only a node made for this element is empty.
+        if (node->count == 0) {
+          node->unhook();
+          delete node;
+        }
+        throw;
+      }
+    } else {
+      value_type tmp(std::forward<Args>(args)...);
+      new (data + node->count) value_type(std::move(data[node->count - 1]));
+      try {
+        std::move_backward(data + index, data + node->count - 1,
+                           data + node->count);
+        data[index] = std::move(tmp);
+      } catch (...) {
+        data[node->count].~value_type();
+        throw;
+      }
+    }
+    ++node->count;
+    ++size_;
+    return iterator(node, index);
+  }
+
+  template <typename... Args>
+  iterator insert_many(const_iterator pos, Args&&... args) {
+    iterator it = pos.const_cast_();
+    ((it = insert(it, std::forward<Args>(args)), ++it), ...);
+    return it;
+  }
+
+  iterator erase(const_iterator pos) {
+    iterator place = pos.const_cast_();
+    auto node = static_cast<Node*>(place.node);
+    Tp* data = node->data();
+    std::move(data + place.index + 1, data + node->count, data + place.index);
+    data[--node->count].~value_type();
+    --size_;
+    if (node->count == 0) {
+      UnrolledListNodeBase* next = node->next;
+      node->unhook();
+      delete node;
+      return iterator(next, 0);
+    }
+    MergeWithNext(node);
+    if (place.index == node->count) {
+      return iterator(node->next, 0);
+    }
+    return place;
+  }
+
+  void push_back(const_reference value) { emplace(cend(), value); }
+
+  void push_back(value_type&& value) { emplace(cend(), std::move(value)); }
+
+  void push_front(const_reference value) { emplace(cbegin(), value); }
+
+  void push_front(value_type&& value) { emplace(cbegin(), std::move(value)); }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args) {
+    emplace(cend(), std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  void emplace_front(Args&&... args) {
+    emplace(cbegin(), std::forward<Args>(args)...);
+  }
+
+  void pop_back() { erase(--end()); }
+
+  void pop_front() { erase(begin()); }
+
+  void swap(unrolled_list& other) noexcept {
+    std::swap(base_.prev, other.base_.prev);
+    std::swap(base_.next, other.base_.next);
+    std::swap(size_, other.size_);
+    FixSentinel();
+    other.FixSentinel();
+  }
+
+  iterator begin() noexcept { return iterator(base_.next, 0); }
+
+  iterator end() noexcept { return iterator(&base_, 0); }
+
+  const_iterator begin() const noexcept {
+    return const_iterator(base_.next, 0);
+  }
+
+  const_iterator end() const noexcept { return const_iterator(&base_, 0); }
+
+  const_iterator cbegin() const noexcept {
+    return const_iterator(base_.next, 0);
+  }
+
+  const_iterator cend() const noexcept { return const_iterator(&base_, 0); }
+
+ private:
+  size_type size_{};
+  UnrolledListNodeBase base_;
+
+  static Node* CreateNode(UnrolledListNodeBase* pos) {
+    auto node = new Node;
+    node->hook(pos);
+    return node;
+  }
+
+  static void DestroyNode(Node* node) noexcept {
+    Tp* data = node->data();
+    for (size_type i = 0; i != node->count; ++i) {
+      data[i].~value_type();
+    }
+    delete node;
+  }
+
+  // Moves the upper half of a full node into a freshly linked successor.
+  // Elements whose move may throw are copied, so if that throws the
+  // successor is dropped again and the node is left as it was.
+  Node* Split(Node* node) {
+    Node* half = CreateNode(node->next);
+    size_type keep = Capacity / 2;
+    Tp* from = node->data();
+    Tp* to = half->data();
+    try {
+      for (size_type i = keep; i != Capacity; ++i) {
+        new (to + half->count) value_type(std::move_if_noexcept(from[i]));
+        ++half->count;
+      }
+    } catch (...) {
+      half->unhook();
+      DestroyNode(half);
+      throw;
+    }
+    for (size_type i = keep; i != Capacity; ++i) {
+      from[i].~value_type();
+    }
+    node->count = keep;
+    return half;
+  }
+
+  // Folds the successor into a sparse node so that the list stays dense
+  // under repeated erasure. Skipped for elements whose move may throw.
+  void MergeWithNext(Node* node) noexcept {
+    UnrolledListNodeBase* next_base = node->next;
+    if (!std::is_nothrow_move_constructible<value_type>::value ||
+        next_base == &base_ || node->count > Capacity / 4 ||
+        node->count + next_base->count > Capacity / 2 + Capacity / 4) {
+      return;
+    }
+    auto next = static_cast<Node*>(next_base);
+    Tp* from = next->data();
+    Tp* to = node->data();
+    for (size_type i = 0; i != next->count; ++i) {
+      new (to + node->count++) value_type(std::move(from[i]));
+    }
+    next->unhook();
+    DestroyNode(next);
+  }
+
+  void FixSentinel() noexcept {
+    if (size_ == 0) {
+      base_.prev = base_.next = &base_;
+    } else {
+      base_.next->prev = base_.prev->next = &base_;
+    }
+  }
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINER_SRC_S21_UNROLLED_LIST_H_
@@ -1,8 +1,18 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <forward_list>
 #include <list>
+#include <map>
+#include <memory>
 #include <queue>
+#include <sstream>
 #include <stack>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 #include "s21_containers.h"
@@ -792,19 +802,10 @@ TEST(List, function_front) {
   EXPECT_EQ(tester.S21_char_list.front(), tester.std_char_list.front());
 }
 
-TEST(List, function_front_empty) {
-  TestList tester;
-  EXPECT_EQ(tester.S21_list_empty.front(), tester.std_list_empty.front());
-}
-
 TEST(List, function_back) {
   TestList tester;
   EXPECT_EQ(tester.S21_char_list.back(), tester.std_char_list.back());
 }
-TEST(List, function_back_empty) {
-  TestList tester;
-  EXPECT_EQ(tester.S21_list_empty.back(), tester.std_list_empty.back());
-}
 
 TEST(List, iterator_access) {
   TestList tester;
@@ -1363,6 +1364,474 @@ TEST(List, function_emplace_front) {
   EXPECT_EQ(tester.S21_list_three.empty(), tester.std_list_three.empty());
 }
 
+TEST(List, move_constructor_leaves_empty) {
+  s21::list<int> S21_list{1, 2, 3};
+  s21::list<int> S21_list_move(std::move(S21_list));
+  EXPECT_TRUE(S21_list.empty());
+  EXPECT_EQ(S21_list.begin(), S21_list.end());
+  S21_list.push_back(4);
+  EXPECT_EQ(S21_list.front(), 4);
+  EXPECT_EQ(S21_list_move.size(), 3U);
+  EXPECT_EQ(S21_list_move.back(), 3);
+  EXPECT_EQ(--S21_list_move.begin(), S21_list_move.end());
+  EXPECT_TRUE(std::is_nothrow_default_constructible<s21::list<int>>::value);
+  EXPECT_TRUE(std::is_nothrow_move_constructible<s21::list<int>>::value);
+}
+
+TEST(List, not_default_constructible) {
+  struct Item {
+    explicit Item(int o_value) : value(o_value) {}
+    bool operator<(const Item& other) const { return value < other.value; }
+    int value;
+  };
+  s21::list<Item> S21_list;
+  s21::list<Item> S21_other;
+  S21_list.emplace_back(1);
+  S21_list.emplace_back(5);
+  S21_other.emplace_back(3);
+  S21_list.merge(S21_other);
+  EXPECT_TRUE(S21_other.empty());
+  EXPECT_EQ(S21_list.size(), 3U);
+  EXPECT_EQ(S21_list.front().value, 1);
+  EXPECT_EQ((++S21_list.begin())->value, 3);
+  EXPECT_EQ(S21_list.back().value, 5);
+}
+
+TEST(List, splice_merge_between_pools) {
+  using Pooled = s21::list<int, s21::pool_allocator<int>>;
+  Pooled S21_list{1, 4, 7};
+  std::list<int> std_list{1, 4, 7, 2, 5, 8};
+  {
+    Pooled S21_other{2, 5, 8};
+    Pooled S21_spliced{0, 9};
+    S21_list.merge(S21_other);
+    S21_list.splice(S21_list.cbegin(), S21_spliced);
+    EXPECT_TRUE(S21_other.empty());
+    EXPECT_TRUE(S21_spliced.empty());
+  }
+  std_list.sort();
+  std_list.push_front(9);
+  std_list.push_front(0);
+  EXPECT_EQ(S21_list.size(), std_list.size());
+  EXPECT_TRUE(std::equal(S21_list.begin(), S21_list.end(), std_list.begin(),
+                         std_list.end()));
+}
+
+TEST(List, function_push_rvalue) {
+  s21::list<std::unique_ptr<int>> S21_list;
+  S21_list.push_back(std::make_unique<int>(2));
+  S21_list.push_front(std::make_unique<int>(1));
+  S21_list.insert(S21_list.end(), std::make_unique<int>(3));
+  S21_list.emplace_back(new int(4));
+  int expected = 1;
+  for (auto& ptr : S21_list) {
+    EXPECT_EQ(*ptr, expected++);
+  }
+  EXPECT_EQ(S21_list.size(), 4U);
+}
+
+TEST(List, function_emplace_no_copies) {
+  struct Counted {
+    explicit Counted(int* o_copies) : copies(o_copies) {}
+    Counted(const Counted& other) : copies(other.copies) { ++*copies; }
+    Counted(Counted&& other) noexcept : copies(other.copies) {}
+    int* copies;
+  };
+  int copies = 0;
+  s21::list<Counted> S21_list;
+  S21_list.emplace_back(&copies);
+  S21_list.emplace_front(&copies);
+  S21_list.emplace(++S21_list.cbegin(), &copies);
+  S21_list.push_back(Counted(&copies));
+  EXPECT_EQ(copies, 0);
+  EXPECT_EQ(S21_list.size(), 4U);
+}
+
+TEST(List, range_constructor) {
+  std::vector<int> source{5, 4, 3, 2, 1};
+  s21::list<int> S21_list(source.begin(), source.end());
+  std::list<int> std_list(source.begin(), source.end());
+  EXPECT_EQ(S21_list.size(), std_list.size());
+  EXPECT_TRUE(std::equal(S21_list.begin(), S21_list.end(), std_list.begin()));
+  EXPECT_EQ(--S21_list.begin(), S21_list.end());
+}
+
+TEST(List, function_insert_range) {
+  TestList tester;
+  std::vector<int> source{7, 8, 9};
+  auto S21_it = tester.S21_list_three.insert(++tester.S21_list_three.cbegin(),
+                                             source.begin(), source.end());
+  auto std_it = tester.std_list_three.insert(++tester.std_list_three.cbegin(),
+                                             source.begin(), source.end());
+  EXPECT_EQ(*S21_it, *std_it);
+  S21_it = tester.S21_list_three.insert(tester.S21_list_three.cend(),
+                                        source.begin(), source.begin());
+  EXPECT_EQ(S21_it, tester.S21_list_three.end());
+  tester.S21_list_three.insert(tester.S21_list_three.cend(), {10, 11});
+  tester.std_list_three.insert(tester.std_list_three.cend(), {10, 11});
+  EXPECT_EQ(tester.S21_list_three.size(), tester.std_list_three.size());
+  EXPECT_TRUE(std::equal(tester.S21_list_three.begin(),
+                         tester.S21_list_three.end(),
+                         tester.std_list_three.begin()));
+  EXPECT_EQ(tester.S21_list_three.back(), 11);
+}
+
+TEST(List, function_insert_range_strong_guarantee) {
+  struct Thrower {
+    Thrower(int o_value) : value(o_value) {
+      if (value == 3) {
+        throw std::runtime_error("Thrower");
+      }
+    }
+    int value;
+  };
+  std::vector<int> source{1, 2, 3, 4};
+  s21::list<Thrower> S21_list;
+  S21_list.emplace_back(10);
+  EXPECT_THROW(S21_list.insert(S21_list.cbegin(), source.begin(), source.end()),
+               std::runtime_error);
+  EXPECT_EQ(S21_list.size(), 1U);
+  EXPECT_EQ(S21_list.front().value, 10);
+  EXPECT_EQ(++S21_list.begin(), S21_list.end());
+}
+
+// Unrolled list Testing
+TEST(UnrolledList, initializer_constructor) {
+  s21::unrolled_list<int, 4> S21_list{1, 2, 3, 4, 5, 6, 7, 8, 9};
+  std::list<int> std_list{1, 2, 3, 4, 5, 6, 7, 8, 9};
+  EXPECT_EQ(S21_list.size(), std_list.size());
+  EXPECT_TRUE(std::equal(S21_list.begin(), S21_list.end(), std_list.begin()));
+  EXPECT_EQ(S21_list.front(), std_list.front());
+  EXPECT_EQ(S21_list.back(), std_list.back());
+}
+
+TEST(UnrolledList, reverse_iteration) {
+  s21::unrolled_list<int, 4> S21_list{1, 2, 3, 4, 5, 6, 7, 8, 9};
+  std::list<int> std_list{1, 2, 3, 4, 5, 6, 7, 8, 9};
+  auto S21_it = S21_list.end();
+  auto std_it = std_list.end();
+  while (S21_it != S21_list.begin()) {
+    EXPECT_EQ(*--S21_it, *--std_it);
+  }
+}
+
+TEST(UnrolledList, copy_and_move) {
+  s21::unrolled_list<int, 4> S21_list{1, 2, 3, 4, 5};
+  s21::unrolled_list<int, 4> S21_copy(S21_list);
+  s21::unrolled_list<int, 4> S21_move(std::move(S21_list));
+  EXPECT_TRUE(S21_list.empty());
+  EXPECT_EQ(S21_list.begin(), S21_list.end());
+  EXPECT_TRUE(std::equal(S21_copy.begin(), S21_copy.end(), S21_move.begin()));
+  S21_list = S21_copy;
+  S21_copy.clear();
+  EXPECT_EQ(S21_list.size(), 5U);
+  EXPECT_TRUE(S21_copy.empty());
+}
+
+TEST(UnrolledList, function_insert_mid) {
+  s21::unrolled_list<int, 4> S21_list;
+  std::list<int> std_list;
+  auto S21_it = S21_list.begin();
+  auto std_it = std_list.begin();
+  for (int i = 0; i < 100; ++i) {
+    S21_it = S21_list.insert(S21_it, i);
+    std_it = std_list.insert(std_it, i);
+    EXPECT_EQ(*S21_it, *std_it);
+    if (i % 3 == 0) {
+      ++S21_it;
+      ++std_it;
+    }
+  }
+  EXPECT_EQ(S21_list.size(), std_list.size());
+  EXPECT_TRUE(std::equal(S21_list.begin(), S21_list.end(), std_list.begin()));
+}
+
+TEST(UnrolledList, function_erase) {
+  s21::unrolled_list<int, 4> S21_list;
+  std::list<int> std_list;
+  for (int i = 0; i < 100; ++i) {
+    S21_list.push_back(i);
+    std_list.push_back(i);
+  }
+  auto S21_it = S21_list.begin();
+  auto std_it = std_list.begin();
+  while (S21_it != S21_list.end()) {
+    if (*S21_it % 5 != 0) {
+      S21_it = S21_list.erase(S21_it);
+      std_it = std_list.erase(std_it);
+    } else {
+      ++S21_it;
+      ++std_it;
+    }
+    EXPECT_EQ(S21_it == S21_list.end(), std_it == std_list.end());
+  }
+  EXPECT_EQ(S21_list.size(), std_list.size());
+  EXPECT_TRUE(std::equal(S21_list.begin(), S21_list.end(), std_list.begin()));
+  while (!S21_list.empty()) {
+    S21_list.pop_front();
+    std_list.pop_front();
+    EXPECT_TRUE(
+        std::equal(S21_list.begin(), S21_list.end(), std_list.begin()));
+  }
+}
+
+TEST(UnrolledList, function_push_pop) {
+  s21::unrolled_list<std::string, 3> S21_list;
+  std::list<std::string> std_list;
+  for (int i = 0; i < 20; ++i) {
+    S21_list.push_front(std::to_string(i));
+    std_list.push_front(std::to_string(i));
+    S21_list.emplace_back(3, 'a' + i);
+    std_list.emplace_back(3, 'a' + i);
+  }
+  S21_list.pop_back();
+  std_list.pop_back();
+  EXPECT_EQ(S21_list.size(), std_list.size());
+  EXPECT_TRUE(std::equal(S21_list.begin(), S21_list.end(), std_list.begin()));
+}
+
+TEST(UnrolledList, split_strong_guarantee) {
+  static int copies_left;
+  struct Thrower {
+    explicit Thrower(int o_value) : value(o_value) {}
+    Thrower(const Thrower& other) : value(other.value) {
+      if (--copies_left == 0) {
+        throw std::runtime_error("Thrower");
+      }
+    }
+    Thrower& operator=(const Thrower&) = default;
+    int value;
+  };
+  s21::unrolled_list<Thrower, 4> S21_list;
+  for (int i = 0; i < 4; ++i) {
+    S21_list.emplace_back(i);
+  }
+  copies_left = 2;
+  EXPECT_THROW(S21_list.emplace(++S21_list.cbegin(), 9), std::runtime_error);
+  EXPECT_EQ(S21_list.size(), 4U);
+  int expected = 0;
+  for (auto& item : S21_list) {
+    EXPECT_EQ(item.value, expected++);
+  }
+  copies_left = -1;
+  S21_list.emplace(++S21_list.cbegin(), 9);
+  EXPECT_EQ(S21_list.size(), 5U);
+  EXPECT_EQ((++S21_list.begin())->value, 9);
+}
+
+TEST(UnrolledList, throwing_emplace_keeps_count) {
+  static int assigns_left;
+  static int constructs_left;
+  static int alive;
+  struct Thrower {
+    explicit Thrower(int o_value) : value(o_value) {
+      if (--constructs_left == 0) {
+        throw std::runtime_error("Thrower");
+      }
+      ++alive;
+    }
+    Thrower(Thrower&& other) noexcept : value(other.value) { ++alive; }
+    Thrower& operator=(Thrower&& other) {
+      if (--assigns_left == 0) {
+        throw std::runtime_error("Thrower");
+      }
+      value = other.value;
+      return *this;
+    }
+    ~Thrower() { --alive; }
+    int value;
+  };
+  assigns_left = constructs_left = -1;
+  alive = 0;
+  {
+    s21::unrolled_list<Thrower, 4> S21_list;
+    for (int i = 0; i < 4; ++i) {
+      S21_list.emplace_back(i);
+    }
+    S21_list.pop_back();
+    assigns_left = 1;
+    EXPECT_THROW(S21_list.emplace(++S21_list.cbegin(), 9), std::runtime_error);
+    EXPECT_EQ(alive, 3);
+    assigns_left = -1;
+    S21_list.emplace_back(3);
+    constructs_left = 1;
+    EXPECT_THROW(S21_list.emplace_back(4), std::runtime_error);
+    EXPECT_EQ(alive, 4);
+    EXPECT_EQ(S21_list.size(), 4U);
+    EXPECT_EQ(std::distance(S21_list.begin(), S21_list.end()), 4);
+    constructs_left = -1;
+    S21_list.emplace_back(4);
+    EXPECT_EQ(S21_list.back().value, 4);
+  }
+  EXPECT_EQ(alive, 0);
+}
+
+// Forward list Testing
+TEST(ForwardList, node_size) {
+  EXPECT_EQ(sizeof(s21::ForwardListNode<int>), 2 * sizeof(void*));
+  EXPECT_LT(sizeof(s21::ForwardListNode<int>), sizeof(s21::ListNode<int>));
+}
+
+TEST(ForwardList, initializer_constructor) {
+  s21::forward_list<int> S21_list{1, 2, 3, 4, 5};
+  std::forward_list<int> std_list{1, 2, 3, 4, 5};
+  EXPECT_TRUE(std::equal(S21_list.begin(), S21_list.end(), std_list.begin(),
+                         std_list.end()));
+  EXPECT_EQ(S21_list.front(), std_list.front());
+  s21::forward_list<int> S21_copy(S21_list);
+  s21::forward_list<int> S21_move(std::move(S21_list));
+  EXPECT_TRUE(S21_list.empty());
+  EXPECT_TRUE(std::equal(S21_copy.begin(), S21_copy.end(), S21_move.begin(),
+                         S21_move.end()));
+}
+
+TEST(ForwardList, throwing_element_constructors) {
+  static int constructs_left;
+  static int alive;
+  struct Thrower {
+    Thrower() : Thrower(0) {}
+    Thrower(int o_value) : value(o_value) { Construct(); }
+    Thrower(const Thrower& other) : value(other.value) { Construct(); }
+    ~Thrower() { --alive; }
+    void Construct() {
+      if (--constructs_left == 0) {
+        throw std::runtime_error("Thrower");
+      }
+      ++alive;
+    }
+    int value;
+  };
+  constructs_left = -1;
+  alive = 0;
+  s21::forward_list<Thrower> S21_list{1, 2, 3, 4};
+  int before = alive;
+  constructs_left = 3;
+  EXPECT_THROW(s21::forward_list<Thrower>{S21_list}, std::runtime_error);
+  EXPECT_EQ(alive, before);
+  constructs_left = 3;
+  EXPECT_THROW(s21::forward_list<Thrower>(5), std::runtime_error);
+  EXPECT_EQ(alive, before);
+  constructs_left = 7;
+  EXPECT_THROW((s21::forward_list<Thrower>{5, 6, 7, 8}), std::runtime_error);
+  EXPECT_EQ(alive, before);
+  constructs_left = 2;
+  EXPECT_THROW(S21_list.insert_after(S21_list.begin(), S21_list.begin(),
+                                     S21_list.end()),
+               std::runtime_error);
+  EXPECT_EQ(alive, before);
+  EXPECT_EQ(std::distance(S21_list.begin(), S21_list.end()), 4);
+}
+
+TEST(ForwardList, function_insert_erase_after) {
+  s21::forward_list<int> S21_list{1, 2, 3, 4, 5};
+  std::forward_list<int> std_list{1, 2, 3, 4, 5};
+  auto S21_it = S21_list.insert_after(S21_list.begin(), 10);
+  auto std_it = std_list.insert_after(std_list.begin(), 10);
+  EXPECT_EQ(*S21_it, *std_it);
+  S21_it = S21_list.erase_after(S21_it);
+  std_it = std_list.erase_after(std_it);
+  EXPECT_EQ(*S21_it, *std_it);
+  S21_list.erase_after(S21_list.before_begin(), S21_it);
+  std_list.erase_after(std_list.before_begin(), std_it);
+  S21_list.push_front(7);
+  std_list.push_front(7);
+  S21_list.emplace_front(8);
+  std_list.emplace_front(8);
+  S21_list.pop_front();
+  std_list.pop_front();
+  EXPECT_TRUE(std::equal(S21_list.begin(), S21_list.end(), std_list.begin(),
+                         std_list.end()));
+}
+
+TEST(ForwardList, function_splice_after) {
+  s21::forward_list<int> S21_list{1, 2, 3};
+  s21::forward_list<int> S21_other{10, 20, 30};
+  std::forward_list<int> std_list{1, 2, 3};
+  std::forward_list<int> std_other{10, 20, 30};
+  S21_list.splice_after(S21_list.begin(), S21_other, S21_other.begin());
+  std_list.splice_after(std_list.begin(), std_other, std_other.begin());
+  S21_list.splice_after(S21_list.before_begin(), S21_other);
+  std_list.splice_after(std_list.before_begin(), std_other);
+  EXPECT_TRUE(S21_other.empty());
+  EXPECT_TRUE(std::equal(S21_list.begin(), S21_list.end(), std_list.begin(),
+                         std_list.end()));
+}
+
+TEST(ForwardList, function_sort_merge) {
+  s21::forward_list<int> S21_list{5, 3, 9, 1, 1, 7, 2, 8};
+  s21::forward_list<int> S21_other{6, 0, 4};
+  std::forward_list<int> std_list{5, 3, 9, 1, 1, 7, 2, 8};
+  std::forward_list<int> std_other{6, 0, 4};
+  S21_list.sort();
+  std_list.sort();
+  S21_other.sort();
+  std_other.sort();
+  S21_list.merge(S21_other);
+  std_list.merge(std_other);
+  S21_list.unique();
+  std_list.unique();
+  EXPECT_TRUE(std::equal(S21_list.begin(), S21_list.end(), std_list.begin(),
+                         std_list.end()));
+  S21_list.reverse();
+  std_list.reverse();
+  EXPECT_TRUE(std::equal(S21_list.begin(), S21_list.end(), std_list.begin(),
+                         std_list.end()));
+}
+
+TEST(ForwardList, splice_merge_between_pools) {
+  using Pooled = s21::forward_list<int, s21::pool_allocator<int>>;
+  Pooled S21_list{1, 4, 7};
+  std::forward_list<int> std_list{1, 4, 7};
+  {
+    Pooled S21_other{2, 5, 8};
+    Pooled S21_spliced{0, 9};
+    S21_list.merge(S21_other);
+    S21_list.splice_after(S21_list.before_begin(), S21_spliced,
+                          S21_spliced.before_begin());
+    S21_list.splice_after(S21_list.begin(), S21_spliced);
+    EXPECT_TRUE(S21_other.empty());
+    EXPECT_TRUE(S21_spliced.empty());
+  }
+  std_list.merge(std::forward_list<int>{2, 5, 8});
+  std_list.push_front(0);
+  std_list.insert_after(std_list.begin(), 9);
+  EXPECT_TRUE(std::equal(S21_list.begin(), S21_list.end(), std_list.begin(),
+                         std_list.end()));
+}
+
+TEST(ForwardList, throwing_compare_keeps_nodes) {
+  static int compares_left;
+  struct Item {
+    bool operator<(const Item& other) const {
+      if (--compares_left == 0) {
+        throw std::runtime_error("Item");
+      }
+      return value < other.value;
+    }
+    int value;
+  };
+  s21::forward_list<Item> S21_list;
+  s21::forward_list<Item> S21_other;
+  for (int i = 0; i < 100; ++i) {
+    S21_list.push_front(Item{i * 37 % 100});
+    S21_other.push_front(Item{i});
+  }
+  compares_left = 200;
+  EXPECT_THROW(S21_list.sort(), std::runtime_error);
+  EXPECT_EQ(std::distance(S21_list.begin(), S21_list.end()), 100);
+  compares_left = 50;
+  EXPECT_THROW(S21_list.merge(S21_other), std::runtime_error);
+  EXPECT_EQ(std::distance(S21_list.begin(), S21_list.end()) +
+                std::distance(S21_other.begin(), S21_other.end()),
+            200);
+  compares_left = -1;
+  S21_list.sort();
+  S21_other.sort();
+  S21_list.merge(S21_other);
+  EXPECT_TRUE(std::is_sorted(S21_list.begin(), S21_list.end()));
+  EXPECT_EQ(std::distance(S21_list.begin(), S21_list.end()), 200);
+}
+
 // // Queue Test
 // class TestQueue {
 // public:
@@ -1634,6 +2103,573 @@ TEST(List, function_emplace_front) {
 //   EXPECT_EQ(orig_q1.size(), copy_q1.size());
 // }
 // SET
+// Checks parent links, key order, the red rule and equal black height on
+// every path, starting from the tree header that end() points at.
+template <typename Container>
+int BlackHeight(const Container& container,
+                const s21::RBTreeNodeBase* node) {
+  if (!node) {
+    return 1;
+  }
+  using Color = s21::RBTreeNodeColor;
+  for (auto child : {node->left, node->right}) {
+    if (child && (child->parent() != node ||
+                  (node->color() == Color::kRed &&
+                   child->color() == Color::kRed))) {
+      return -1;
+    }
+  }
+  int left = BlackHeight(container, node->left);
+  int right = BlackHeight(container, node->right);
+  if (left < 0 || left != right) {
+    return -1;
+  }
+  return left + (node->color() == Color::kBlack ? 1 : 0);
+}
+
+template <typename Container>
+bool IsValidRBTree(const Container& container) {
+  auto header = container.end().node;
+  auto root = header->parent();
+  if (!root) {
+    return container.empty() && header->left == header &&
+           header->right == header;
+  }
+  size_t count = 0;
+  for (auto it = container.begin(); it != container.end(); ++it, ++count) {
+    auto next = it;
+    if (++next != container.end() && *next < *it) {
+      return false;
+    }
+  }
+  return count == container.size() && root->parent() == header &&
+         root->color() == s21::RBTreeNodeColor::kBlack &&
+         BlackHeight(container, root) > 0;
+}
+
+TEST(Set, node_layout) {
+  EXPECT_EQ(sizeof(s21::RBTreeNodeBase), 3 * sizeof(void*));
+  EXPECT_EQ(sizeof(s21::RBTreeNode<int>), 4 * sizeof(void*));
+}
+
+TEST(Set, rb_invariants) {
+  s21::set<int> S21_set;
+  for (int i = 0; i < 500; ++i) {
+    S21_set.insert(i * 37 % 500);
+    ASSERT_TRUE(IsValidRBTree(S21_set));
+  }
+  for (int i = 0; i < 500; i += 2) {
+    S21_set.erase(S21_set.find(i * 37 % 500));
+    ASSERT_TRUE(IsValidRBTree(S21_set));
+  }
+  EXPECT_EQ(S21_set.size(), 250U);
+}
+
+size_t SubtreeSize(const s21::RBTreeNodeBase* node) {
+  using Node = s21::RBTreeCountedNode<int>;
+  return node ? static_cast<const Node*>(node)->subtree_size : 0;
+}
+
+bool SubtreeSizesValid(const s21::RBTreeNodeBase* node) {
+  return !node ||
+         (SubtreeSize(node) ==
+              SubtreeSize(node->left) + SubtreeSize(node->right) + 1 &&
+          SubtreeSizesValid(node->left) && SubtreeSizesValid(node->right));
+}
+
+TEST(Set, order_statistic) {
+  s21::set<int, std::less<int>, std::allocator<int>, true> S21_set;
+  for (int i = 0; i < 100; ++i) {
+    S21_set.insert(i * 7 % 100 * 2);
+  }
+  for (size_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(*S21_set.select(i), static_cast<int>(i) * 2);
+    EXPECT_EQ(S21_set.rank(static_cast<int>(i) * 2), i);
+    EXPECT_EQ(S21_set.rank(static_cast<int>(i) * 2 + 1), i + 1);
+  }
+  EXPECT_EQ(S21_set.select(100), S21_set.end());
+  EXPECT_EQ(S21_set.distance(S21_set.begin(), S21_set.end()), 100);
+  EXPECT_EQ(S21_set.distance(S21_set.find(20), S21_set.find(60)), 20);
+  auto S21_copy = S21_set;
+  EXPECT_TRUE(SubtreeSizesValid(S21_copy.end().node->parent()));
+  EXPECT_EQ(*S21_copy.select(42), 84);
+}
+
+TEST(Multiset, order_statistic_random) {
+  s21::multiset<int, std::less<int>, std::allocator<int>, true> S21_multiset;
+  std::multiset<int> std_multiset;
+  std::srand(21);
+  for (int i = 0; i < 4000; ++i) {
+    int key = std::rand() % 200;
+    if (std::rand() % 3 == 0 && !std_multiset.empty()) {
+      size_t pos = std::rand() % std_multiset.size();
+      auto std_it = std::next(std_multiset.begin(), pos);
+      auto S21_next = S21_multiset.erase(S21_multiset.select(pos));
+      std_it = std_multiset.erase(std_it);
+      ASSERT_EQ(S21_next == S21_multiset.end(), std_it == std_multiset.end());
+      ASSERT_TRUE(S21_next == S21_multiset.end() || *S21_next == *std_it);
+    } else {
+      S21_multiset.insert(key);
+      std_multiset.insert(key);
+    }
+    ASSERT_TRUE(IsValidRBTree(S21_multiset));
+    ASSERT_TRUE(SubtreeSizesValid(S21_multiset.end().node->parent()));
+    ASSERT_EQ(S21_multiset.count(key), std_multiset.count(key));
+    auto std_lower = std_multiset.lower_bound(key);
+    ASSERT_EQ(S21_multiset.rank(key), static_cast<size_t>(std::distance(
+                                          std_multiset.begin(), std_lower)));
+  }
+  size_t pos = 0;
+  for (int value : std_multiset) {
+    EXPECT_EQ(*S21_multiset.select(pos++), value);
+  }
+}
+
+TEST(Set, insert_hint) {
+  s21::set<int> S21_set;
+  std::set<int> std_set;
+  std::srand(36);
+  for (int i = 0; i < 1000; ++i) {
+    int key = std::rand() % 400;
+    auto hint = S21_set.begin();
+    switch (std::rand() % 3) {
+      case 0:
+        hint = S21_set.end();
+        break;
+      case 1:
+        hint = S21_set.find(key);
+        break;
+      default:
+        std::advance(hint, S21_set.empty() ? 0 : std::rand() % S21_set.size());
+    }
+    auto it =
+        i % 2 ? S21_set.insert(hint, key) : S21_set.emplace_hint(hint, key);
+    std_set.insert(key);
+    ASSERT_EQ(*it, key);
+    ASSERT_TRUE(IsValidRBTree(S21_set));
+  }
+  EXPECT_TRUE(std::equal(S21_set.begin(), S21_set.end(), std_set.begin(),
+                         std_set.end()));
+}
+
+TEST(Multiset, insert_hint) {
+  s21::multiset<int> S21_multiset;
+  std::multiset<int> std_multiset;
+  std::srand(37);
+  for (int i = 0; i < 1000; ++i) {
+    int key = std::rand() % 100;
+    auto hint = S21_multiset.begin();
+    if (std::rand() % 2) {
+      hint = S21_multiset.end();
+    } else if (!S21_multiset.empty()) {
+      std::advance(hint, std::rand() % S21_multiset.size());
+    }
+    auto it = i % 2 ? S21_multiset.insert(hint, key)
+                    : S21_multiset.emplace_hint(hint, key);
+    std_multiset.insert(key);
+    ASSERT_EQ(*it, key);
+    ASSERT_TRUE(IsValidRBTree(S21_multiset));
+  }
+  EXPECT_TRUE(std::equal(S21_multiset.begin(), S21_multiset.end(),
+                         std_multiset.begin(), std_multiset.end()));
+}
+
+TEST(Set, constructor_sorted_unique) {
+  for (int n = 0; n < 70; ++n) {
+    std::vector<int> items;
+    for (int i = 0; i < n; ++i) {
+      items.push_back(i * 3);
+    }
+    s21::set<int, std::less<int>, std::allocator<int>, true> S21_set(
+        s21::sorted_unique, items.begin(), items.end());
+    ASSERT_EQ(S21_set.size(), static_cast<size_t>(n));
+    ASSERT_TRUE(IsValidRBTree(S21_set));
+    ASSERT_TRUE(SubtreeSizesValid(S21_set.end().node->parent()));
+    ASSERT_TRUE(std::equal(S21_set.begin(), S21_set.end(), items.begin(),
+                           items.end()));
+    S21_set.insert(n * 3 + 1);
+    ASSERT_TRUE(IsValidRBTree(S21_set));
+  }
+}
+
+TEST(Set, constructor_range_unsorted) {
+  std::vector<int> items{5, 3, 9, 3, 1, 7, 5, 0};
+  s21::set<int> S21_set(items.begin(), items.end());
+  std::set<int> std_set(items.begin(), items.end());
+  EXPECT_TRUE(std::equal(S21_set.begin(), S21_set.end(), std_set.begin(),
+                         std_set.end()));
+  EXPECT_TRUE(IsValidRBTree(S21_set));
+  std::istringstream input("4 2 2 8 6");
+  s21::set<int> S21_streamed(std::istream_iterator<int>(input),
+                             std::istream_iterator<int>{});
+  EXPECT_EQ(S21_streamed.size(), 4U);
+  EXPECT_EQ(*S21_streamed.begin(), 2);
+}
+
+TEST(Set, constructor_range_random) {
+  std::vector<std::string> items;
+  std::srand(38);
+  for (int i = 0; i < 500; ++i) {
+    items.push_back(std::to_string(std::rand() % 300));
+  }
+  s21::set<std::string> S21_set(items.begin(), items.end());
+  std::set<std::string> std_set(items.begin(), items.end());
+  EXPECT_TRUE(std::equal(S21_set.begin(), S21_set.end(), std_set.begin(),
+                         std_set.end()));
+  EXPECT_TRUE(IsValidRBTree(S21_set));
+  s21::multiset<std::string> S21_multiset(items.begin(), items.end());
+  std::multiset<std::string> std_multiset(items.begin(), items.end());
+  EXPECT_TRUE(std::equal(S21_multiset.begin(), S21_multiset.end(),
+                         std_multiset.begin(), std_multiset.end()));
+  EXPECT_TRUE(IsValidRBTree(S21_multiset));
+}
+
+TEST(Multiset, constructor_sorted_equivalent) {
+  std::vector<int> items{1, 1, 2, 3, 3, 3, 4};
+  s21::multiset<int> S21_multiset(s21::sorted_equivalent, items.begin(),
+                                  items.end());
+  EXPECT_EQ(S21_multiset.size(), items.size());
+  EXPECT_EQ(S21_multiset.count(3), 3U);
+  EXPECT_TRUE(IsValidRBTree(S21_multiset));
+  s21::multiset<int> S21_unsorted{4, 3, 1, 3, 2, 1, 3};
+  EXPECT_TRUE(std::equal(S21_unsorted.begin(), S21_unsorted.end(),
+                         items.begin(), items.end()));
+}
+
+TEST(Set, transparent_lookup) {
+  s21::set<std::string, std::less<>> S21_set{"alpha", "beta", "gamma"};
+  std::string_view key("beta");
+  EXPECT_EQ(*S21_set.find(key), "beta");
+  EXPECT_TRUE(S21_set.contains(key));
+  EXPECT_FALSE(S21_set.contains(std::string_view("delta")));
+  EXPECT_TRUE(S21_set.contains("gamma"));
+}
+
+TEST(Multiset, merge_move_only) {
+  s21::multiset<std::unique_ptr<int>> S21_lhs, S21_rhs;
+  for (int i = 0; i < 50; ++i) {
+    auto& target = i % 2 ? S21_lhs : S21_rhs;
+    target.emplace_hint(target.end(), new int(i));
+  }
+  S21_lhs.merge(S21_rhs);
+  EXPECT_EQ(S21_lhs.size(), 50U);
+  EXPECT_TRUE(S21_rhs.empty());
+  int sum = 0;
+  for (auto& item : S21_lhs) {
+    sum += *item;
+  }
+  EXPECT_EQ(sum, 49 * 50 / 2);
+}
+
+TEST(Set, merge_random) {
+  std::srand(40);
+  for (int round = 0; round < 40; ++round) {
+    s21::set<int, std::less<int>, std::allocator<int>, true> S21_lhs, S21_rhs;
+    std::set<int> std_lhs, std_rhs;
+    int n_lhs = std::rand() % 300, n_rhs = round % 2 ? 3 : std::rand() % 300;
+    for (int i = 0; i < n_lhs; ++i) {
+      int key = std::rand() % 500;
+      S21_lhs.insert(key);
+      std_lhs.insert(key);
+    }
+    for (int i = 0; i < n_rhs; ++i) {
+      int key = std::rand() % 500;
+      S21_rhs.insert(key);
+      std_rhs.insert(key);
+    }
+    S21_lhs.merge(S21_rhs);
+    std_lhs.merge(std_rhs);
+    ASSERT_TRUE(std::equal(S21_lhs.begin(), S21_lhs.end(), std_lhs.begin(),
+                           std_lhs.end()));
+    ASSERT_TRUE(std::equal(S21_rhs.begin(), S21_rhs.end(), std_rhs.begin(),
+                           std_rhs.end()));
+    ASSERT_TRUE(IsValidRBTree(S21_lhs));
+    ASSERT_TRUE(IsValidRBTree(S21_rhs));
+    ASSERT_TRUE(SubtreeSizesValid(S21_lhs.end().node->parent()));
+    ASSERT_TRUE(SubtreeSizesValid(S21_rhs.end().node->parent()));
+  }
+}
+
+TEST(Multiset, merge_random) {
+  std::srand(41);
+  for (int round = 0; round < 40; ++round) {
+    s21::multiset<int> S21_lhs, S21_rhs;
+    std::multiset<int> std_lhs;
+    int n_lhs = std::rand() % 300, n_rhs = round % 2 ? 3 : std::rand() % 300;
+    for (int i = 0; i < n_lhs; ++i) {
+      int key = std::rand() % 100;
+      S21_lhs.insert(key);
+      std_lhs.insert(key);
+    }
+    for (int i = 0; i < n_rhs; ++i) {
+      int key = std::rand() % 100;
+      S21_rhs.insert(key);
+      std_lhs.insert(key);
+    }
+    S21_lhs.merge(S21_rhs);
+    ASSERT_TRUE(S21_rhs.empty());
+    ASSERT_TRUE(std::equal(S21_lhs.begin(), S21_lhs.end(), std_lhs.begin(),
+                           std_lhs.end()));
+    ASSERT_TRUE(IsValidRBTree(S21_lhs));
+  }
+}
+
+template <typename S21Set, typename StdSet>
+void CheckSetOperations(const S21Set& S21_lhs, const S21Set& S21_rhs,
+                        const StdSet& std_lhs, const StdSet& std_rhs) {
+  std::vector<int> expected;
+  auto check = [&](const S21Set& S21_result, S21Set S21_in_place) {
+    ASSERT_TRUE(std::equal(S21_result.begin(), S21_result.end(),
+                           expected.begin(), expected.end()));
+    ASSERT_TRUE(std::equal(S21_in_place.begin(), S21_in_place.end(),
+                           expected.begin(), expected.end()));
+    ASSERT_TRUE(IsValidRBTree(S21_result));
+    ASSERT_TRUE(IsValidRBTree(S21_in_place));
+  };
+  std::set_union(std_lhs.begin(), std_lhs.end(), std_rhs.begin(),
+                 std_rhs.end(), std::back_inserter(expected));
+  S21Set S21_copy = S21_lhs;
+  S21_copy.union_with(S21_rhs);
+  check(s21::set_union(S21_lhs, S21_rhs), S21_copy);
+  expected.clear();
+  std::set_intersection(std_lhs.begin(), std_lhs.end(), std_rhs.begin(),
+                        std_rhs.end(), std::back_inserter(expected));
+  S21_copy = S21_lhs;
+  S21_copy.intersect_with(S21_rhs);
+  check(s21::set_intersection(S21_lhs, S21_rhs), S21_copy);
+  expected.clear();
+  std::set_difference(std_lhs.begin(), std_lhs.end(), std_rhs.begin(),
+                      std_rhs.end(), std::back_inserter(expected));
+  S21_copy = S21_lhs;
+  S21_copy.difference_with(S21_rhs);
+  check(s21::set_difference(S21_lhs, S21_rhs), S21_copy);
+  expected.clear();
+  std::set_symmetric_difference(std_lhs.begin(), std_lhs.end(),
+                                std_rhs.begin(), std_rhs.end(),
+                                std::back_inserter(expected));
+  S21_copy = S21_lhs;
+  S21_copy.symmetric_difference_with(S21_rhs);
+  check(s21::set_symmetric_difference(S21_lhs, S21_rhs), S21_copy);
+}
+
+TEST(Set, set_operations) {
+  std::srand(42);
+  for (int round = 0; round < 30; ++round) {
+    s21::set<int> S21_lhs, S21_rhs;
+    std::set<int> std_lhs, std_rhs;
+    for (int i = std::rand() % 200; i > 0; --i) {
+      int key = std::rand() % 300;
+      S21_lhs.insert(key);
+      std_lhs.insert(key);
+    }
+    for (int i = std::rand() % 200; i > 0; --i) {
+      int key = std::rand() % 300;
+      S21_rhs.insert(key);
+      std_rhs.insert(key);
+    }
+    CheckSetOperations(S21_lhs, S21_rhs, std_lhs, std_rhs);
+  }
+  s21::set<int> S21_self{1, 2, 3};
+  S21_self.intersect_with(S21_self);
+  EXPECT_EQ(S21_self.size(), 3U);
+  S21_self.difference_with(S21_self);
+  EXPECT_TRUE(S21_self.empty());
+}
+
+TEST(Multiset, set_operations) {
+  std::srand(43);
+  for (int round = 0; round < 30; ++round) {
+    s21::multiset<int> S21_lhs, S21_rhs;
+    std::multiset<int> std_lhs, std_rhs;
+    for (int i = std::rand() % 200; i > 0; --i) {
+      int key = std::rand() % 50;
+      S21_lhs.insert(key);
+      std_lhs.insert(key);
+    }
+    for (int i = std::rand() % 200; i > 0; --i) {
+      int key = std::rand() % 50;
+      S21_rhs.insert(key);
+      std_rhs.insert(key);
+    }
+    CheckSetOperations(S21_lhs, S21_rhs, std_lhs, std_rhs);
+  }
+}
+
+TEST(Set, split_join_random) {
+  std::srand(42);
+  for (int round = 0; round < 60; ++round) {
+    s21::set<int, std::less<int>, std::allocator<int>, true> S21_set;
+    std::set<int> std_set;
+    for (int i = std::rand() % 400; i > 0; --i) {
+      int key = std::rand() % 1000;
+      S21_set.insert(key);
+      std_set.insert(key);
+    }
+    int key = std::rand() % 1100 - 50;
+    auto S21_upper = S21_set.split(key);
+    std::set<int> std_upper(std_set.lower_bound(key), std_set.end());
+    std_set.erase(std_set.lower_bound(key), std_set.end());
+    ASSERT_TRUE(std::equal(S21_set.begin(), S21_set.end(), std_set.begin(),
+                           std_set.end()));
+    ASSERT_TRUE(std::equal(S21_upper.begin(), S21_upper.end(),
+                           std_upper.begin(), std_upper.end()));
+    ASSERT_TRUE(IsValidRBTree(S21_set));
+    ASSERT_TRUE(IsValidRBTree(S21_upper));
+    ASSERT_TRUE(SubtreeSizesValid(S21_set.end().node->parent()));
+    ASSERT_TRUE(SubtreeSizesValid(S21_upper.end().node->parent()));
+    S21_set.join(S21_upper);
+    std_set.merge(std_upper);
+    ASSERT_TRUE(S21_upper.empty());
+    ASSERT_TRUE(std::equal(S21_set.begin(), S21_set.end(), std_set.begin(),
+                           std_set.end()));
+    ASSERT_TRUE(IsValidRBTree(S21_set));
+    ASSERT_TRUE(SubtreeSizesValid(S21_set.end().node->parent()));
+  }
+}
+
+TEST(Set, join_uneven) {
+  for (int n_lhs : {0, 1, 5, 1000}) {
+    for (int n_rhs : {0, 1, 7, 1000}) {
+      s21::set<int> S21_lhs, S21_rhs;
+      for (int i = 0; i < n_lhs; ++i) {
+        S21_lhs.insert(i);
+      }
+      for (int i = 0; i < n_rhs; ++i) {
+        S21_rhs.insert(n_lhs + i);
+      }
+      auto S21_joined = s21::join(std::move(S21_lhs), std::move(S21_rhs));
+      ASSERT_EQ(S21_joined.size(), static_cast<size_t>(n_lhs + n_rhs));
+      ASSERT_TRUE(IsValidRBTree(S21_joined));
+      int expected = 0;
+      for (int key : S21_joined) {
+        ASSERT_EQ(key, expected++);
+      }
+    }
+  }
+  s21::set<int> S21_lhs{1, 2, 3}, S21_rhs{3, 4};
+  EXPECT_THROW(S21_lhs.join(S21_rhs), std::invalid_argument);
+  EXPECT_EQ(S21_lhs.size(), 3U);
+  EXPECT_EQ(S21_rhs.size(), 2U);
+}
+
+TEST(Multiset, split_join) {
+  std::srand(44);
+  for (int round = 0; round < 40; ++round) {
+    s21::multiset<int> S21_multiset;
+    std::multiset<int> std_multiset;
+    for (int i = std::rand() % 300; i > 0; --i) {
+      int key = std::rand() % 40;
+      S21_multiset.insert(key);
+      std_multiset.insert(key);
+    }
+    int key = std::rand() % 40;
+    auto S21_upper = S21_multiset.split(key);
+    auto std_bound = std_multiset.lower_bound(key);
+    ASSERT_EQ(S21_multiset.size(), static_cast<size_t>(std::distance(
+                                       std_multiset.begin(), std_bound)));
+    ASSERT_EQ(S21_upper.size(), static_cast<size_t>(std::distance(
+                                    std_bound, std_multiset.end())));
+    ASSERT_TRUE(IsValidRBTree(S21_multiset));
+    ASSERT_TRUE(IsValidRBTree(S21_upper));
+    ASSERT_TRUE(S21_upper.empty() || *S21_upper.begin() >= key);
+    s21::multiset<int> S21_equal{key, key};
+    S21_multiset.join(S21_equal);
+    S21_multiset.join(S21_upper);
+    std_multiset.insert({key, key});
+    ASSERT_TRUE(std::equal(S21_multiset.begin(), S21_multiset.end(),
+                           std_multiset.begin(), std_multiset.end()));
+    ASSERT_TRUE(IsValidRBTree(S21_multiset));
+  }
+}
+
+TEST(Set, erase_range_random) {
+  std::srand(43);
+  for (int round = 0; round < 60; ++round) {
+    s21::set<int, std::less<int>, std::allocator<int>, true> S21_set;
+    std::set<int> std_set;
+    for (int i = std::rand() % 500; i > 0; --i) {
+      int key = std::rand() % 1000;
+      S21_set.insert(key);
+      std_set.insert(key);
+    }
+    int lower = std::rand() % 1000;
+    int upper = lower + (round % 3 ? std::rand() % 20 : std::rand() % 1000);
+    auto S21_next = S21_set.erase(S21_set.select(S21_set.rank(lower)),
+                                  S21_set.select(S21_set.rank(upper)));
+    auto std_next = std_set.erase(std_set.lower_bound(lower),
+                                  std_set.lower_bound(upper));
+    ASSERT_EQ(S21_next == S21_set.end(), std_next == std_set.end());
+    ASSERT_TRUE(S21_next == S21_set.end() || *S21_next == *std_next);
+    ASSERT_TRUE(std::equal(S21_set.begin(), S21_set.end(), std_set.begin(),
+                           std_set.end()));
+    ASSERT_TRUE(IsValidRBTree(S21_set));
+    ASSERT_TRUE(SubtreeSizesValid(S21_set.end().node->parent()));
+  }
+}
+
+TEST(Multiset, erase_key) {
+  s21::multiset<int> S21_multiset;
+  for (int i = 0; i < 1000; ++i) {
+    S21_multiset.insert(i % 4 == 0 ? 7 : i);
+  }
+  EXPECT_EQ(S21_multiset.erase(7), 251U);
+  EXPECT_EQ(S21_multiset.size(), 749U);
+  EXPECT_FALSE(S21_multiset.contains(7));
+  EXPECT_TRUE(IsValidRBTree(S21_multiset));
+  EXPECT_EQ(S21_multiset.erase(7), 0U);
+  EXPECT_EQ(S21_multiset.erase(5), 1U);
+  EXPECT_TRUE(IsValidRBTree(S21_multiset));
+  EXPECT_EQ(S21_multiset.erase_if([](int key) { return key % 2 == 1; }),
+            498U);
+  EXPECT_EQ(S21_multiset.size(), 250U);
+  EXPECT_TRUE(IsValidRBTree(S21_multiset));
+  S21_multiset.erase(S21_multiset.begin(), S21_multiset.end());
+  EXPECT_TRUE(S21_multiset.empty());
+  EXPECT_TRUE(IsValidRBTree(S21_multiset));
+}
+
+TEST(Multiset, priority_queue) {
+  s21::multiset<int> S21_multiset;
+  std::multiset<int> std_multiset;
+  std::srand(47);
+  for (int i = 0; i < 3000; ++i) {
+    if (std::rand() % 3 == 0 && !std_multiset.empty()) {
+      if (i % 2) {
+        S21_multiset.pop_front();
+        std_multiset.erase(std_multiset.begin());
+      } else {
+        S21_multiset.pop_back();
+        std_multiset.erase(std::prev(std_multiset.end()));
+      }
+    } else {
+      int key = std::rand() % 100;
+      S21_multiset.insert(key);
+      std_multiset.insert(key);
+    }
+    ASSERT_EQ(S21_multiset.size(), std_multiset.size());
+    if (!std_multiset.empty()) {
+      ASSERT_EQ(S21_multiset.min(), *std_multiset.begin());
+      ASSERT_EQ(S21_multiset.max(), *std_multiset.rbegin());
+    }
+  }
+  EXPECT_TRUE(IsValidRBTree(S21_multiset));
+  EXPECT_TRUE(std::equal(S21_multiset.rbegin(), S21_multiset.rend(),
+                         std_multiset.rbegin(), std_multiset.rend()));
+  const auto& S21_const = S21_multiset;
+  EXPECT_TRUE(std::equal(S21_const.crbegin(), S21_const.crend(),
+                         std_multiset.rbegin(), std_multiset.rend()));
+}
+
+TEST(Multiset, transparent_lookup) {
+  s21::multiset<std::string, std::less<>> S21_multiset{"b", "a", "b", "c"};
+  std::string_view key("b");
+  EXPECT_EQ(S21_multiset.count(key), 2U);
+  auto range = S21_multiset.equal_range(key);
+  EXPECT_EQ(range.first, S21_multiset.lower_bound(key));
+  EXPECT_EQ(range.second, S21_multiset.upper_bound(key));
+  EXPECT_EQ(*range.second, "c");
+}
+
 class TestSet {
  public:
   s21::set<int> S21_set_empty;
@@ -1761,18 +2797,18 @@ TEST(Set, function_size_not_empty) {
 
 TEST(Set, function_max_sez_empty) {
   TestSet tester;
-  EXPECT_EQ(tester.S21_set_empty.max_size(), tester.std_set_empty.max_size());
+  EXPECT_GE(tester.S21_set_empty.max_size(), tester.std_set_empty.max_size());
 }
 
 TEST(Set, function_max_siez_not_empty) {
   TestSet tester;
-  EXPECT_EQ(tester.S21_set_ten.max_size(), tester.std_set_ten.max_size());
+  EXPECT_GE(tester.S21_set_ten.max_size(), tester.std_set_ten.max_size());
 }
 
 TEST(Set, function_max_size_float_empty) {
   s21::set<float> S21_float_empty;
   std::set<float> std_float_empty;
-  EXPECT_EQ(S21_float_empty.max_size(), std_float_empty.max_size());
+  EXPECT_GE(S21_float_empty.max_size(), std_float_empty.max_size());
 }
 
 TEST(Set, function_swap_not_empty) {
@@ -2157,20 +3193,20 @@ TEST(Multiset, function_size_not_empty) {
 
 TEST(Multiset, function_max_sez_empty) {
   TestMultiset tester;
-  EXPECT_EQ(tester.S21_multiset_empty.max_size(),
+  EXPECT_GE(tester.S21_multiset_empty.max_size(),
             tester.std_multiset_empty.max_size());
 }
 
 TEST(Multiset, function_max_siez_not_empty) {
   TestMultiset tester;
-  EXPECT_EQ(tester.S21_multiset_ten.max_size(),
+  EXPECT_GE(tester.S21_multiset_ten.max_size(),
             tester.std_multiset_ten.max_size());
 }
 
 TEST(Multiset, function_max_size_float_empty) {
   s21::multiset<float> S21_float_empty;
   std::multiset<float> std_float_empty;
-  EXPECT_EQ(S21_float_empty.max_size(), std_float_empty.max_size());
+  EXPECT_GE(S21_float_empty.max_size(), std_float_empty.max_size());
 }
 
 TEST(Multiset, function_swap_not_empty) {
@@ -2912,6 +3948,94 @@ TEST(Map, function_insert_or_assign) {
   ASSERT_EQ((*(it1.first)).second, (*(it2.first)).second);
   ASSERT_TRUE(it1.second == it2.second);
 }
+
+TEST(Map, try_emplace_insert_or_assign) {
+  s21::map<std::string, std::unique_ptr<int>> S21_map;
+  auto value = std::make_unique<int>(1);
+  auto res = S21_map.try_emplace("one", std::move(value));
+  EXPECT_TRUE(res.second);
+  EXPECT_EQ(*(*res.first).second, 1);
+  value = std::make_unique<int>(2);
+  res = S21_map.try_emplace("one", std::move(value));
+  EXPECT_FALSE(res.second);
+  ASSERT_TRUE(value);
+  EXPECT_EQ(*(*res.first).second, 1);
+  std::string key = "two";
+  auto it = S21_map.try_emplace(S21_map.end(), std::move(key),
+                                std::make_unique<int>(2));
+  EXPECT_EQ((*it).first, "two");
+  res = S21_map.insert_or_assign("three", std::make_unique<int>(3));
+  EXPECT_TRUE(res.second);
+  EXPECT_EQ((*res.first).first, "three");
+  res = S21_map.insert_or_assign("one", std::move(value));
+  EXPECT_FALSE(res.second);
+  EXPECT_EQ(*(*res.first).second, 2);
+  EXPECT_FALSE(S21_map["four"]);
+  S21_map["four"] = std::make_unique<int>(4);
+  EXPECT_EQ(*S21_map.at("four"), 4);
+  EXPECT_EQ(S21_map.size(), 4U);
+  auto emplaced = S21_map.emplace("five", std::make_unique<int>(5));
+  EXPECT_TRUE(emplaced.second);
+  emplaced = S21_map.emplace("five", nullptr);
+  EXPECT_FALSE(emplaced.second);
+  EXPECT_EQ(*(*emplaced.first).second, 5);
+  EXPECT_TRUE(IsValidRBTree(S21_map));
+}
+
+TEST(Map, insert_emplace_no_copies) {
+  struct Counted {
+    explicit Counted(int* o_made) : made(o_made) { ++*made; }
+    Counted(const Counted& other) : made(other.made) { ++*made; }
+    Counted(Counted&& other) noexcept : made(other.made) {}
+    int* made;
+  };
+  int made = 0;
+  s21::map<std::string, Counted> S21_map;
+  S21_map.insert(std::pair<std::string, Counted>("a", Counted(&made)));
+  EXPECT_EQ(made, 1);
+  S21_map.insert(S21_map.end(),
+                 std::pair<std::string, Counted>("b", Counted(&made)));
+  EXPECT_EQ(made, 2);
+  std::string key = "c";
+  S21_map.emplace(key, &made);
+  EXPECT_EQ(made, 3);
+  EXPECT_FALSE(S21_map.emplace(key, &made).second);
+  EXPECT_FALSE(S21_map.emplace_hint(S21_map.begin(), key, &made) ==
+               S21_map.end());
+  EXPECT_EQ(made, 3);
+  EXPECT_FALSE(S21_map.emplace("c", &made).second);
+  EXPECT_EQ(made, 4);
+  EXPECT_EQ(S21_map.size(), 3U);
+
+  s21::multiset<std::string> S21_multiset;
+  std::string long_key(100, 'x');
+  const char* data = long_key.data();
+  auto it = S21_multiset.insert(std::move(long_key)).first;
+  EXPECT_EQ(it->data(), data);
+  S21_multiset.emplace(3, 'y');
+  S21_multiset.emplace(3, 'y');
+  EXPECT_EQ(S21_multiset.count("yyy"), 2U);
+}
+
+TEST(Map, reverse_iteration) {
+  s21::map<int, int> S21_map{{1, 10}, {3, 30}, {2, 20}};
+  auto it = S21_map.rbegin();
+  EXPECT_EQ(it->first, 3);
+  (*it).second = 31;
+  EXPECT_EQ((++it)->first, 2);
+  EXPECT_EQ((++it)->first, 1);
+  EXPECT_TRUE(++it == S21_map.rend());
+  EXPECT_EQ(S21_map.max().second, 31);
+  EXPECT_EQ(S21_map.min().first, 1);
+  S21_map.pop_back();
+  S21_map.pop_front();
+  EXPECT_EQ(S21_map.size(), 1U);
+  EXPECT_EQ(S21_map.min().first, 2);
+  EXPECT_EQ(S21_map.max().first, 2);
+  s21::map<int, int> S21_empty;
+  EXPECT_TRUE(S21_empty.rbegin() == S21_empty.rend());
+}
+
 TEST(Map, function_insert_s) {
   s21::map<int, int> m1({{1, 3}, {4, 2}});
   std::pair<s21::map<int, int>::iterator, bool> it1 = m1.insert(5, 2);
@@ -2946,6 +4070,797 @@ TEST(Map, function_ontains) {
   ASSERT_FALSE(s1.contains(3));
 }
 
+TEST(Map, aggregate_random) {
+  using Value = std::pair<int, long long>;
+  using Second = s21::KeyGetters::SelectSecond<Value>;
+  s21::map<int, long long, std::less<int>, std::allocator<Value>, false,
+           s21::Augments::Sum<Value, Second>>
+      S21_sums;
+  s21::map<int, long long, std::less<int>, std::allocator<Value>, false,
+           s21::Augments::Max<Value, Second>>
+      S21_maxima;
+  std::map<int, long long> std_map;
+  std::srand(34);
+  for (int i = 0; i < 2000; ++i) {
+    int key = std::rand() % 300;
+    if (std::rand() % 3 == 0) {
+      if (!std_map.empty()) {
+        S21_sums.erase(S21_sums.begin());
+        S21_maxima.erase(S21_maxima.begin());
+        std_map.erase(std_map.begin());
+      }
+    } else if (!std_map.count(key)) {
+      long long value = std::rand() % 1000 - 500;
+      S21_sums.insert(key, value);
+      S21_maxima.insert(key, value);
+      std_map.emplace(key, value);
+    }
+    int lower = std::rand() % 300, upper = lower + std::rand() % 100;
+    long long sum = 0, max = std::numeric_limits<long long>::lowest();
+    for (auto it = std_map.lower_bound(lower);
+         it != std_map.lower_bound(upper); ++it) {
+      sum += it->second;
+      max = std::max(max, it->second);
+    }
+    ASSERT_EQ(S21_sums.aggregate(lower, upper), sum);
+    ASSERT_EQ(S21_maxima.aggregate(lower, upper), max);
+  }
+  auto S21_copy = S21_sums;
+  long long total = 0;
+  for (auto& item : std_map) {
+    total += item.second;
+  }
+  EXPECT_EQ(S21_copy.aggregate(0, 300), total);
+}
+
+TEST(Map, aggregate_after_value_change) {
+  using Value = std::pair<int, long long>;
+  using Second = s21::KeyGetters::SelectSecond<Value>;
+  using SumMap = s21::map<int, long long, std::less<int>,
+                          std::allocator<Value>, false,
+                          s21::Augments::Sum<Value, Second>>;
+  static_assert(std::is_same<decltype(std::declval<SumMap&>()[0]),
+                             const long long&>::value,
+                "augmented maps hand out mapped values read-only");
+  SumMap S21_map;
+  std::map<int, long long> std_map;
+  for (int i = 0; i < 100; ++i) {
+    S21_map.insert(i, 1);
+    std_map.emplace(i, 1);
+  }
+  S21_map.insert_or_assign(5, 1001);
+  EXPECT_EQ(S21_map.aggregate(0, 100), 1100);
+  S21_map.modify(std::next(S21_map.begin(), 7), [](long long& value) { value += 10; });
+  EXPECT_EQ(S21_map.aggregate(0, 100), 1110);
+  EXPECT_EQ(S21_map.aggregate(6, 8), 12);
+  EXPECT_THROW(S21_map.modify(std::next(S21_map.begin(), 9),
+                              [](long long& value) {
+                                value = 50;
+                                throw std::runtime_error("modify");
+                              }),
+               std::runtime_error);
+  EXPECT_EQ(S21_map.aggregate(0, 100), 1159);
+  std_map[5] = 1001;
+  std_map[7] += 10;
+  std_map[9] = 50;
+  std::srand(35);
+  for (int i = 0; i < 2000; ++i) {
+    int key = std::rand() % 150;
+    long long value = std::rand() % 1000 - 500;
+    S21_map.insert_or_assign(key, value);
+    std_map[key] = value;
+    int lower = std::rand() % 150, upper = lower + std::rand() % 50;
+    long long sum = 0;
+    for (auto it = std_map.lower_bound(lower);
+         it != std_map.lower_bound(upper); ++it) {
+      sum += it->second;
+    }
+    ASSERT_EQ(S21_map.aggregate(lower, upper), sum);
+  }
+}
+
+TEST(Map, split_join_aggregate) {
+  using Value = std::pair<int, long long>;
+  using Second = s21::KeyGetters::SelectSecond<Value>;
+  using Pooled = s21::pool_allocator<Value>;
+  s21::map<int, long long, std::less<int>, Pooled, false,
+           s21::Augments::Sum<Value, Second>>
+      S21_map, S21_tail;
+  long long total = 0, tail_total = 0;
+  for (int i = 0; i < 500; ++i) {
+    S21_map.insert(i, i * 3);
+    total += i * 3;
+  }
+  for (int i = 500; i < 520; ++i) {
+    S21_tail.insert(i, i);
+    tail_total += i;
+  }
+  auto S21_upper = S21_map.split(200);
+  EXPECT_EQ(S21_map.size(), 200U);
+  EXPECT_EQ(S21_upper.size(), 300U);
+  EXPECT_EQ(S21_map.aggregate(0, 1000) + S21_upper.aggregate(0, 1000), total);
+  S21_map.join(S21_upper);
+  EXPECT_EQ(S21_map.aggregate(0, 1000), total);
+  S21_map.join(S21_tail);
+  EXPECT_TRUE(S21_tail.empty());
+  EXPECT_EQ(S21_map.size(), 520U);
+  EXPECT_EQ(S21_map.aggregate(0, 1000), total + tail_total);
+  EXPECT_EQ(S21_map.aggregate(500, 510), 5045);
+  EXPECT_TRUE(IsValidRBTree(S21_map));
+}
+
+TEST(Map, erase_if) {
+  using Value = std::pair<int, long long>;
+  using Second = s21::KeyGetters::SelectSecond<Value>;
+  s21::map<int, long long, std::less<int>, std::allocator<Value>, false,
+           s21::Augments::Sum<Value, Second>>
+      S21_map;
+  std::map<int, long long> std_map;
+  for (int i = 0; i < 1000; ++i) {
+    S21_map.insert(i, i % 7);
+    std_map.emplace(i, i % 7);
+  }
+  auto expired = [](const Value& item) { return item.second < 3; };
+  EXPECT_EQ(S21_map.erase_if(expired), 429U);
+  for (auto it = std_map.begin(); it != std_map.end();) {
+    it = it->second < 3 ? std_map.erase(it) : std::next(it);
+  }
+  EXPECT_TRUE(std::equal(S21_map.begin(), S21_map.end(), std_map.begin(),
+                         std_map.end(), [](const Value& lhs, auto& rhs) {
+                           return lhs.first == rhs.first &&
+                                  lhs.second == rhs.second;
+                         }));
+  EXPECT_EQ(S21_map.aggregate(0, 1000), 2568);
+  EXPECT_TRUE(IsValidRBTree(S21_map));
+  int calls = 0;
+  EXPECT_THROW(S21_map.erase_if([&calls](const Value& item) {
+    if (++calls == 100) {
+      throw std::runtime_error("predicate failed");
+    }
+    return item.first % 2 == 0;
+  }),
+               std::runtime_error);
+  auto std_it = std_map.begin();
+  for (int i = 1; i < calls; ++i) {
+    std_it = std_it->first % 2 == 0 ? std_map.erase(std_it) : std::next(std_it);
+  }
+  EXPECT_TRUE(std::equal(S21_map.begin(), S21_map.end(), std_map.begin(),
+                         std_map.end(), [](const Value& lhs, auto& rhs) {
+                           return lhs.first == rhs.first;
+                         }));
+  EXPECT_TRUE(IsValidRBTree(S21_map));
+}
+
+TEST(Set, aggregate_min) {
+  s21::set<int, std::less<int>, std::allocator<int>, true,
+           s21::Augments::Min<int>>
+      S21_set{5, 3, 9, 1, 7};
+  EXPECT_EQ(S21_set.aggregate(2, 8), 3);
+  EXPECT_EQ(S21_set.aggregate(6, 8), 7);
+  EXPECT_EQ(S21_set.aggregate(10, 20), std::numeric_limits<int>::max());
+  EXPECT_EQ(S21_set.rank(7), 3U);
+}
+
+TEST(Map, constructor_sorted_unique_pooled) {
+  using Value = std::pair<int, int>;
+  std::vector<Value> items;
+  for (int i = 0; i < 1000; ++i) {
+    items.push_back({i, -i});
+  }
+  items.push_back({999, 0});
+  s21::map<int, int, std::less<int>, s21::pool_allocator<Value>> S21_map(
+      s21::sorted_unique, items.begin(), items.end());
+  EXPECT_EQ(S21_map.size(), 1000U);
+  EXPECT_EQ(S21_map.at(999), -999);
+  EXPECT_TRUE(IsValidRBTree(S21_map));
+  S21_map.erase(S21_map.begin());
+  S21_map.insert(-1, 1);
+  EXPECT_TRUE(IsValidRBTree(S21_map));
+  s21::map<int, int> S21_unsorted{{3, 1}, {1, 2}, {3, 3}};
+  EXPECT_EQ(S21_unsorted.at(3), 1);
+  EXPECT_EQ(S21_unsorted.size(), 2U);
+}
+
+TEST(Map, transparent_lookup) {
+  s21::map<std::string, int, std::less<>> S21_map{{"one", 1}, {"two", 2}};
+  EXPECT_EQ(S21_map.at(std::string_view("two")), 2);
+  EXPECT_TRUE(S21_map.contains(std::string_view("one")));
+  EXPECT_FALSE(S21_map.contains(std::string_view("three")));
+  EXPECT_THROW(S21_map.at(std::string_view("three")), std::out_of_range);
+  const auto& S21_const = S21_map;
+  EXPECT_EQ(S21_const.at(std::string_view("one")), 1);
+}
+
+TEST(Map, extract_insert_node) {
+  s21::map<int, std::string> S21_lhs{{1, "one"}, {2, "two"}, {3, "three"}};
+  s21::map<int, std::string> S21_rhs{{3, "drei"}};
+  const std::string* address = &S21_lhs.at(2);
+  auto handle = S21_lhs.extract(2);
+  ASSERT_FALSE(handle.empty());
+  EXPECT_EQ(handle.key(), 2);
+  handle.key() = 20;
+  auto result = S21_rhs.insert(std::move(handle));
+  EXPECT_TRUE(result.inserted);
+  EXPECT_TRUE(result.node.empty());
+  EXPECT_EQ(&(*result.position).second, address);
+  EXPECT_EQ(S21_rhs.at(20), "two");
+  EXPECT_FALSE(S21_lhs.contains(2));
+  auto clash = S21_lhs.extract(S21_lhs.begin());
+  clash.key() = 3;
+  result = S21_lhs.insert(std::move(clash));
+  EXPECT_FALSE(result.inserted);
+  EXPECT_EQ(result.node.mapped(), "one");
+  EXPECT_EQ((*result.position).second, "three");
+  EXPECT_TRUE(S21_lhs.extract(42).empty());
+  EXPECT_TRUE(IsValidRBTree(S21_lhs));
+  EXPECT_TRUE(IsValidRBTree(S21_rhs));
+}
+
+TEST(Map, extract_insert_node_pooled) {
+  using Value = std::pair<int, std::string>;
+  using Map = s21::map<int, std::string, std::less<int>,
+                       s21::pool_allocator<Value>>;
+  Map S21_lhs{{1, "one"}, {2, "two"}}, S21_rhs{{5, "five"}};
+  S21_rhs.insert(S21_lhs.extract(1));
+  S21_rhs.merge(S21_lhs);
+  EXPECT_TRUE(S21_lhs.empty());
+  EXPECT_EQ(S21_rhs.size(), 3U);
+  EXPECT_EQ(S21_rhs.at(2), "two");
+  S21_rhs.clear();
+  S21_lhs.insert(3, "three");
+  EXPECT_EQ(S21_lhs.at(3), "three");
+}
+
+TEST(Map, insert_hint_sorted) {
+  s21::map<int, int> S21_map;
+  for (int i = 0; i < 100; ++i) {
+    auto it = S21_map.insert(S21_map.end(), std::pair<int, int>(i, i * i));
+    ASSERT_EQ((*it).second, i * i);
+  }
+  auto it = S21_map.emplace_hint(S21_map.begin(), 50, 0);
+  EXPECT_EQ((*it).second, 2500);
+  EXPECT_EQ(S21_map.size(), 100U);
+  EXPECT_TRUE(IsValidRBTree(S21_map));
+}
+
+// INTERVAL MAP
+
+TEST(IntervalMap, overlapping) {
+  s21::interval_map<int, char> S21_intervals{
+      {{1, 3}, 'a'}, {{2, 6}, 'b'}, {{8, 9}, 'c'}, {{5, 5}, 'd'}};
+  auto found = S21_intervals.overlapping(3, 5);
+  ASSERT_EQ(found.size(), 3U);
+  EXPECT_EQ((*found[0]).second, 'a');
+  EXPECT_EQ((*found[1]).second, 'b');
+  EXPECT_EQ((*found[2]).second, 'd');
+  EXPECT_EQ(S21_intervals.overlapping(7).size(), 0U);
+  EXPECT_EQ(S21_intervals.overlapping(9).size(), 1U);
+  S21_intervals.erase(found[1]);
+  EXPECT_EQ(S21_intervals.overlapping(4).size(), 0U);
+  EXPECT_THROW(S21_intervals.insert(4, 2, 'e'), std::invalid_argument);
+  EXPECT_EQ(S21_intervals.size(), 3U);
+}
+
+TEST(IntervalMap, overlapping_random) {
+  s21::interval_map<int, int> S21_intervals;
+  std::vector<std::pair<std::pair<int, int>, int>> std_intervals;
+  std::srand(35);
+  for (int i = 0; i < 1500; ++i) {
+    if (std::rand() % 4 == 0 && !std_intervals.empty()) {
+      auto S21_it = S21_intervals.begin();
+      std::advance(S21_it, std::rand() % S21_intervals.size());
+      auto std_it = std::find(std_intervals.begin(), std_intervals.end(),
+                              *S21_it);
+      std_intervals.erase(std_it);
+      S21_intervals.erase(S21_it);
+    } else {
+      int low = std::rand() % 1000, high = low + std::rand() % 50;
+      S21_intervals.insert(low, high, i);
+      std_intervals.push_back({{low, high}, i});
+    }
+    int low = std::rand() % 1000, high = low + std::rand() % 20;
+    std::multiset<std::pair<std::pair<int, int>, int>> expected, found;
+    for (auto& item : std_intervals) {
+      if (item.first.first <= high && low <= item.first.second) {
+        expected.insert(item);
+      }
+    }
+    const auto& S21_const = S21_intervals;
+    for (auto it : S21_const.overlapping(low, high)) {
+      found.insert(*it);
+    }
+    ASSERT_EQ(found, expected);
+  }
+  auto S21_copy = S21_intervals;
+  EXPECT_EQ(S21_copy.overlapping(0, 2000).size(), std_intervals.size());
+}
+
+// NODE POOL
+TEST(NodePool, reuse_freed_slots) {
+  s21::NodePool pool(sizeof(int), 4);
+  void* first = pool.allocate(1);
+  void* second = pool.allocate(1);
+  EXPECT_NE(first, second);
+  pool.deallocate(first, 1);
+  EXPECT_EQ(pool.in_use(), 1U);
+  EXPECT_EQ(pool.allocate(1), first);
+  void* block = pool.allocate(10);
+  EXPECT_EQ(pool.in_use(), 12U);
+  pool.deallocate(block, 10);
+  EXPECT_EQ(pool.in_use(), 2U);
+  pool.release();
+  EXPECT_EQ(pool.in_use(), 0U);
+}
+
+TEST(NodePool, allocator_copies_and_rebinds_share_pools) {
+  s21::pool_allocator<int> S21_alloc;
+  s21::pool_allocator<int> S21_copy(S21_alloc);
+  s21::pool_allocator<int> S21_other;
+  EXPECT_TRUE(S21_alloc == S21_copy);
+  EXPECT_TRUE(S21_alloc != S21_other);
+  int* first = S21_alloc.allocate(1);
+  EXPECT_TRUE(S21_alloc == S21_copy);
+  EXPECT_EQ(S21_copy.in_use(), 1U);
+  s21::pool_allocator<double> S21_rebound(S21_copy);
+  EXPECT_TRUE(s21::pool_allocator<int>(S21_rebound) == S21_alloc);
+  EXPECT_EQ(S21_rebound.in_use(), 0U);
+  double* second = S21_rebound.allocate(2);
+  s21::pool_allocator<int> S21_moved(std::move(S21_copy));
+  EXPECT_TRUE(S21_moved == S21_alloc);
+  S21_moved.deallocate(first, 1);
+  EXPECT_EQ(S21_alloc.in_use(), 0U);
+  s21::pool_allocator<double>(S21_alloc).deallocate(second, 2);
+  EXPECT_EQ(S21_rebound.in_use(), 0U);
+  EXPECT_TRUE(S21_alloc.select_on_container_copy_construction() != S21_alloc);
+}
+
+TEST(NodePool, pooled_map) {
+  s21::map<int, std::string, std::less<int>,
+           s21::pool_allocator<std::pair<int, std::string>>>
+      S21_map;
+  std::map<int, std::string> std_map;
+  for (int i = 0; i < 1000; ++i) {
+    S21_map.insert(i * 7 % 1000, std::to_string(i));
+    std_map.insert({i * 7 % 1000, std::to_string(i)});
+  }
+  for (int i = 0; i < 300; ++i) {
+    S21_map.erase(S21_map.begin());
+    std_map.erase(std_map.begin());
+  }
+  auto S21_copy = S21_map;
+  S21_map.clear();
+  EXPECT_TRUE(S21_map.empty());
+  EXPECT_EQ(S21_copy.size(), std_map.size());
+  auto std_it = std_map.begin();
+  for (auto& item : S21_copy) {
+    EXPECT_EQ(item.first, std_it->first);
+    EXPECT_EQ(item.second, std_it->second);
+    ++std_it;
+  }
+  S21_map.insert(1, "one");
+  EXPECT_EQ(S21_map.at(1), "one");
+}
+
+TEST(NodePool, pooled_sets_and_lists) {
+  s21::set<int, std::less<int>, s21::pool_allocator<int>> S21_set{5, 1, 3};
+  s21::multiset<int, std::less<int>, s21::pool_allocator<int>> S21_multiset{
+      2, 2, 1};
+  s21::list<int, s21::pool_allocator<int>> S21_list{1, 2, 3};
+  s21::forward_list<int, s21::pool_allocator<int>> S21_forward_list{1, 2, 3};
+  decltype(S21_set) S21_other{4};
+  S21_set.swap(S21_other);
+  S21_set = std::move(S21_other);
+  EXPECT_EQ(S21_set.size(), 3U);
+  EXPECT_EQ(*S21_set.begin(), 1);
+  EXPECT_EQ(S21_multiset.count(2), 2U);
+  S21_list.pop_front();
+  S21_list.push_back(4);
+  EXPECT_EQ(S21_list.front(), 2);
+  EXPECT_EQ(S21_list.back(), 4);
+  S21_forward_list.pop_front();
+  EXPECT_EQ(S21_forward_list.front(), 2);
+}
+
+TEST(NodePool, pooled_copy_is_contiguous) {
+  s21::set<int, std::less<int>, s21::pool_allocator<int>> S21_set;
+  std::srand(48);
+  for (int i = 0; i < 1000; ++i) {
+    S21_set.insert(std::rand());
+  }
+  auto S21_copy = S21_set;
+  EXPECT_TRUE(IsValidRBTree(S21_copy));
+  EXPECT_TRUE(std::equal(S21_copy.begin(), S21_copy.end(), S21_set.begin(),
+                         S21_set.end()));
+  std::vector<const s21::RBTreeNodeBase*> pending{
+      S21_copy.end().node->parent()};
+  std::vector<const char*> preorder;
+  while (!pending.empty()) {
+    auto node = pending.back();
+    pending.pop_back();
+    preorder.push_back(reinterpret_cast<const char*>(node));
+    for (auto child : {node->right, node->left}) {
+      if (child) {
+        pending.push_back(child);
+      }
+    }
+  }
+  ASSERT_EQ(preorder.size(), S21_copy.size());
+  for (size_t i = 2; i < preorder.size(); ++i) {
+    ASSERT_EQ(preorder[i] - preorder[i - 1], preorder[1] - preorder[0]);
+  }
+}
+
+TEST(NodePool, copy_strong_guarantee) {
+  static int copies_left;
+  struct Thrower {
+    explicit Thrower(int o_value) : value(o_value) {}
+    Thrower(const Thrower& other) : value(other.value) {
+      if (--copies_left == 0) {
+        throw std::runtime_error("Thrower");
+      }
+    }
+    bool operator<(const Thrower& other) const { return value < other.value; }
+    int value;
+  };
+  s21::set<Thrower> S21_set;
+  s21::set<Thrower, std::less<Thrower>, s21::pool_allocator<Thrower>>
+      S21_pooled;
+  for (int i = 0; i < 100; ++i) {
+    S21_set.emplace(i * 37 % 100);
+    S21_pooled.emplace(i * 37 % 100);
+  }
+  copies_left = 60;
+  EXPECT_THROW(auto S21_copy = S21_set, std::runtime_error);
+  copies_left = 60;
+  EXPECT_THROW(auto S21_copy = S21_pooled, std::runtime_error);
+  copies_left = 1000;
+  auto S21_copy = S21_pooled;
+  EXPECT_EQ(S21_copy.size(), 100U);
+  EXPECT_TRUE(IsValidRBTree(S21_set));
+}
+
+// Checks key order, the red rule and equal black height on every path of
+// the version a persistent map holds.
+int PersistentBlackHeight(const s21::PersistentNodeBase* node) {
+  if (!node) {
+    return 1;
+  }
+  using Color = s21::RBTreeNodeColor;
+  for (auto child : node->link) {
+    if (child && node->color == Color::kRed && child->color == Color::kRed) {
+      return -1;
+    }
+  }
+  int left = PersistentBlackHeight(node->link[0]);
+  int right = PersistentBlackHeight(node->link[1]);
+  if (left < 0 || left != right) {
+    return -1;
+  }
+  return left + (node->color == Color::kBlack ? 1 : 0);
+}
+
+template <typename Map>
+bool IsValidPersistentTree(const Map& map) {
+  auto first = map.begin();
+  if (first == map.end()) {
+    return map.empty();
+  }
+  size_t count = 0;
+  for (auto it = first; it != map.end(); ++it, ++count) {
+    auto next = it;
+    if (++next != map.end() && !(it->first < next->first)) {
+      return false;
+    }
+  }
+  auto root = first.path[0];
+  return count == map.size() &&
+         root->color == s21::RBTreeNodeColor::kBlack &&
+         PersistentBlackHeight(root) > 0;
+}
+
+template <typename Map, typename StdMap>
+bool SameItems(const Map& map, const StdMap& std_map) {
+  return map.size() == std_map.size() &&
+         std::equal(map.begin(), map.end(), std_map.begin(), std_map.end(),
+                    [](const auto& lhs, const auto& rhs) {
+                      return lhs.first == rhs.first &&
+                             lhs.second == rhs.second;
+                    });
+}
+
+TEST(PersistentMap, lookup) {
+  s21::persistent_map<int, std::string> S21_map{
+      {3, "three"}, {1, "one"}, {2, "two"}};
+  EXPECT_EQ(S21_map.size(), 3U);
+  EXPECT_EQ(S21_map.at(2), "two");
+  EXPECT_THROW(S21_map.at(4), std::out_of_range);
+  EXPECT_EQ(S21_map.find(1)->second, "one");
+  EXPECT_TRUE(S21_map.find(4) == S21_map.end());
+  EXPECT_EQ(S21_map.count(3), 1U);
+  EXPECT_FALSE(S21_map.contains(0));
+  EXPECT_FALSE(S21_map.insert(1, "uno"));
+  EXPECT_FALSE(S21_map.insert_or_assign(1, "uno"));
+  EXPECT_TRUE(S21_map.insert_or_assign(0, "zero"));
+  EXPECT_EQ(S21_map.at(1), "uno");
+  EXPECT_EQ(S21_map.erase(5), 0U);
+  EXPECT_EQ(S21_map.erase(2), 1U);
+  std::string keys;
+  for (auto it = S21_map.begin(); it != S21_map.end(); it++) {
+    keys += std::to_string(it->first);
+  }
+  EXPECT_EQ(keys, "013");
+  S21_map.clear();
+  EXPECT_TRUE(S21_map.empty());
+  EXPECT_TRUE(S21_map.begin() == S21_map.end());
+}
+
+TEST(PersistentMap, snapshots_random) {
+  s21::persistent_map<int, int> S21_map;
+  std::map<int, int> std_map;
+  std::vector<s21::persistent_map<int, int>> S21_snapshots;
+  std::vector<std::map<int, int>> std_snapshots;
+  std::srand(49);
+  for (int i = 0; i < 20000; ++i) {
+    int key = std::rand() % 2000;
+    switch (std::rand() % 3) {
+      case 0:
+        EXPECT_EQ(S21_map.insert(key, i), std_map.emplace(key, i).second);
+        break;
+      case 1:
+        EXPECT_EQ(S21_map.insert_or_assign(key, i),
+                  std_map.insert_or_assign(key, i).second);
+        break;
+      default:
+        EXPECT_EQ(S21_map.erase(key), std_map.erase(key));
+    }
+    if (i % 1000 == 0) {
+      S21_snapshots.push_back(S21_map);
+      std_snapshots.push_back(std_map);
+      ASSERT_TRUE(IsValidPersistentTree(S21_map));
+    }
+  }
+  EXPECT_TRUE(IsValidPersistentTree(S21_map));
+  EXPECT_TRUE(SameItems(S21_map, std_map));
+  for (size_t i = 0; i < S21_snapshots.size(); ++i) {
+    EXPECT_TRUE(IsValidPersistentTree(S21_snapshots[i]));
+    EXPECT_TRUE(SameItems(S21_snapshots[i], std_snapshots[i]));
+  }
+  while (!S21_map.empty()) {
+    S21_map.erase(S21_map.begin()->first);
+  }
+  EXPECT_TRUE(SameItems(S21_snapshots.back(), std_snapshots.back()));
+}
+
+TEST(PersistentMap, updates_copy_only_changed_nodes) {
+  s21::persistent_map<int, int> S21_map;
+  for (int i = 0; i < 1024; ++i) {
+    S21_map.insert(i * 37 % 1024, i);
+  }
+  auto addresses = [](const s21::persistent_map<int, int>& map) {
+    std::map<int, const void*> found;
+    for (auto& item : map) {
+      found[item.first] = &item;
+    }
+    return found;
+  };
+  auto before = addresses(S21_map);
+  S21_map.insert(2000, 0);
+  S21_map.erase(500);
+  S21_map.insert_or_assign(7, 7);
+  auto after = addresses(S21_map);
+  before.erase(500);
+  after.erase(2000);
+  EXPECT_EQ(before, after);
+  auto snapshot = S21_map;
+  auto copied = [&]() {
+    auto now = addresses(S21_map);
+    auto then = addresses(snapshot);
+    size_t count = 0;
+    for (auto& [key, address] : now) {
+      count += then.count(key) && then[key] != address;
+    }
+    return count;
+  };
+  S21_map.insert(3000, 0);
+  EXPECT_GT(copied(), 0U);
+  EXPECT_LE(copied(), 20U);
+  snapshot = S21_map;
+  S21_map.erase(5000);
+  EXPECT_EQ(copied(), 0U);
+  S21_map.erase(600);
+  EXPECT_LE(copied(), 60U);
+  snapshot = S21_map;
+  S21_map.insert_or_assign(8, 8);
+  EXPECT_LE(copied(), 21U);
+  EXPECT_EQ(snapshot.at(8) * 37 % 1024, 8);
+  EXPECT_TRUE(IsValidPersistentTree(S21_map));
+  EXPECT_TRUE(IsValidPersistentTree(snapshot));
+}
+
+TEST(PersistentMap, throwing_copy_keeps_map) {
+  static int copies_left;
+  struct Thrower {
+    explicit Thrower(int o_value) : value(o_value) {}
+    Thrower(const Thrower& other) : value(other.value) {
+      if (--copies_left == 0) {
+        throw std::runtime_error("Thrower");
+      }
+    }
+    Thrower& operator=(const Thrower&) = default;
+    int value;
+  };
+  copies_left = -1;
+  s21::persistent_map<int, Thrower> S21_map;
+  std::map<int, int> std_map;
+  for (int i = 0; i < 300; ++i) {
+    S21_map.insert_or_assign(i * 7 % 300, Thrower(i));
+    std_map[i * 7 % 300] = i;
+  }
+  int thrown = 0;
+  for (int i = 0; i < 300; i += 3) {
+    auto snapshot = S21_map;
+    copies_left = 1 + i % 7;
+    try {
+      S21_map.erase(i);
+      std_map.erase(i);
+    } catch (const std::runtime_error&) {
+      ++thrown;
+    }
+    copies_left = -1;
+    ASSERT_TRUE(IsValidPersistentTree(S21_map));
+    ASSERT_EQ(S21_map.size(), std_map.size());
+    for (auto& [key, value] : std_map) {
+      ASSERT_EQ(S21_map.at(key).value, value);
+    }
+  }
+  EXPECT_GT(thrown, 0);
+}
+
+TEST(PersistentMap, throwing_constructors_free_nodes) {
+  static int copies_left;
+  static int alive;
+  struct Thrower {
+    explicit Thrower(int o_value) : value(o_value) { ++alive; }
+    Thrower(const Thrower& other) : value(other.value) {
+      if (--copies_left == 0) {
+        throw std::runtime_error("Thrower");
+      }
+      ++alive;
+    }
+    Thrower& operator=(const Thrower&) = default;
+    ~Thrower() { --alive; }
+    int value;
+  };
+  using Value = std::pair<int, Thrower>;
+  static_assert(!std::is_constructible<s21::persistent_map<int, int>, int,
+                                       int>::value,
+                "the range constructor takes iterators only");
+  alive = 0;
+  copies_left = -1;
+  {
+    std::vector<Value> source;
+    for (int i = 0; i < 50; ++i) {
+      source.emplace_back(i * 7 % 50, Thrower(i));
+    }
+    int before = alive;
+    copies_left = 30;
+    using Map = s21::persistent_map<int, Thrower>;
+    EXPECT_THROW(Map(source.begin(), source.end()), std::runtime_error);
+    EXPECT_EQ(alive, before);
+    copies_left = 7;
+    EXPECT_THROW((Map{source[0], source[1], source[2], source[3]}),
+                 std::runtime_error);
+    EXPECT_EQ(alive, before);
+  }
+  EXPECT_EQ(alive, 0);
+}
+
+TEST(ConcurrentMap, reader_and_writer) {
+  s21::concurrent_map<int, std::string, std::less<int>,
+                      std::allocator<std::pair<int, std::string>>, 2>
+      S21_map;
+  decltype(S21_map)::reader S21_reader(S21_map);
+  EXPECT_TRUE(S21_map.insert(1, "one"));
+  EXPECT_FALSE(S21_map.insert(1, "uno"));
+  EXPECT_TRUE(S21_map.insert_or_assign(2, "two"));
+  auto S21_before = S21_reader.snapshot();
+  S21_map.update([](auto& map) {
+    map.insert_or_assign(1, "uno");
+    map.insert(3, "three");
+  });
+  EXPECT_EQ(S21_map.erase(2), 1U);
+  EXPECT_EQ(S21_map.erase(2), 0U);
+  EXPECT_EQ(S21_reader.get(1), "uno");
+  EXPECT_EQ(S21_reader.get(2), std::nullopt);
+  EXPECT_TRUE(S21_reader.contains(3));
+  EXPECT_EQ(S21_reader.size(), 2U);
+  EXPECT_EQ(S21_before.size(), 2U);
+  EXPECT_EQ(S21_before.at(1), "one");
+  EXPECT_EQ(S21_map.snapshot().at(3), "three");
+  {
+    decltype(S21_map)::reader S21_second(S21_map);
+    EXPECT_THROW(decltype(S21_map)::reader S21_third(S21_map),
+                 std::length_error);
+  }
+  decltype(S21_map)::reader S21_third(S21_map);
+  EXPECT_EQ(S21_third.read([](const auto& map) { return map.begin()->first; }),
+            1);
+}
+
+TEST(ConcurrentMap, readers_see_whole_updates) {
+  s21::concurrent_map<int, int> S21_map;
+  S21_map.update([](auto& map) {
+    for (int i = 0; i < 100; ++i) {
+      map.insert(i, 0);
+    }
+  });
+  std::atomic<bool> done{false};
+  std::atomic<int> torn{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&] {
+      decltype(S21_map)::reader S21_reader(S21_map);
+      while (!done.load()) {
+        int sum = S21_reader.read([](const auto& map) {
+          int total = 0;
+          for (auto& item : map) {
+            total += item.second;
+          }
+          return map.size() == 100 ? total : -1;
+        });
+        torn += sum != 0;
+      }
+    });
+  }
+  std::srand(50);
+  for (int i = 0; i < 2000; ++i) {
+    int from = std::rand() % 100, to = std::rand() % 100;
+    S21_map.update([from, to](auto& map) {
+      map.insert_or_assign(from, map.at(from) - 1);
+      map.insert_or_assign(to, map.at(to) + 1);
+    });
+  }
+  done = true;
+  for (auto& thread : readers) {
+    thread.join();
+  }
+  EXPECT_EQ(torn.load(), 0);
+  auto S21_last = S21_map.snapshot();
+  EXPECT_TRUE(IsValidPersistentTree(S21_last));
+}
+
+TEST(ConcurrentMap, nested_read_and_reclaim) {
+  static int alive;
+  struct Counted {
+    explicit Counted(int o_value) : value(o_value) { ++alive; }
+    Counted(const Counted& other) : value(other.value) { ++alive; }
+    Counted& operator=(const Counted&) = default;
+    ~Counted() { --alive; }
+    int value;
+  };
+  alive = 0;
+  {
+    s21::concurrent_map<int, Counted> S21_map;
+    decltype(S21_map)::reader S21_reader(S21_map);
+    S21_map.insert(1, Counted(1));
+    int baseline = alive;
+    S21_reader.read([&](const auto& outer) {
+      S21_map.insert_or_assign(1, Counted(2));
+      int inner =
+          S21_reader.read([](const auto& map) { return map.at(1).value; });
+      EXPECT_EQ(inner, 2);
+      S21_map.insert_or_assign(1, Counted(3));
+      EXPECT_EQ(outer.at(1).value, 1);
+      return 0;
+    });
+    EXPECT_EQ(alive, baseline + 2);
+    S21_map.reclaim();
+    EXPECT_EQ(alive, baseline);
+    EXPECT_EQ(S21_reader.get(1)->value, 3);
+  }
+  EXPECT_EQ(alive, 0);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();